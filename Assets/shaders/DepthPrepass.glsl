@@ -0,0 +1,36 @@
+#type vertex
+#version 450 core
+
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    mat4 u_ViewProjection;
+    mat4 u_InverseView;
+    mat4 u_InverseProjection;
+    mat4 u_InverseViewProjection;
+    vec4 u_CameraPosition;
+    vec2 u_ViewportSize;
+    float u_Time;
+    float u_DeltaTime;
+};
+
+// Reads the geometry arena's position buffer, so the instance attributes start right after the position
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in mat4 a_ModelMatrix;
+
+// Has to match the depth of the material shaders exactly, they test against it with less-or-equal
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = u_ViewProjection * a_ModelMatrix * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+void main()
+{
+}
@@ -1,11 +1,25 @@
 // Flat Color Shader
 
 #type vertex
-#version 330 core
+#version 450 core
 
 layout(location = 0) in vec3 a_Position;
 
-uniform mat4 u_ViewProjection;
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	mat4 u_InverseView;
+	mat4 u_InverseProjection;
+	mat4 u_InverseViewProjection;
+	vec4 u_CameraPosition;
+	vec2 u_ViewportSize;
+	float u_Time;
+	float u_DeltaTime;
+};
+
 uniform mat4 u_Transform;
 
 out vec2 v_TexCoord;
@@ -16,7 +30,7 @@ void main()
 }		
 
 #type fragment
-#version 330 core
+#version 450 core
 
 layout(location = 0) out vec4 color;
 
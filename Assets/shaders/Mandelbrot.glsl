@@ -1,9 +1,19 @@
 #type vertex
 #version 450 core
 
-layout(std140, binding = 0) uniform CameraData
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
 {
+    mat4 u_View;
+    mat4 u_Projection;
     mat4 u_ViewProjection;
+    mat4 u_InverseView;
+    mat4 u_InverseProjection;
+    mat4 u_InverseViewProjection;
+    vec4 u_CameraPosition;
+    vec2 u_ViewportSize;
+    float u_Time;
+    float u_DeltaTime;
 };
 
 layout(location = 0) in vec3 a_Position;
@@ -13,6 +23,9 @@ layout(location = 3) in mat4 a_ModelMatrix;
 
 out vec2 v_TexCoord;
 
+// Drawn after the depth prepass, which has to produce the same depth
+invariant gl_Position;
+
 void main()
 {
     v_TexCoord = a_TexCoord;
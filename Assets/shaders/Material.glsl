@@ -1,36 +1,79 @@
 #type vertex
 #version 450 core
 
-layout(std140, binding = 0) uniform CameraData
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
 {
+    mat4 u_View;
+    mat4 u_Projection;
     mat4 u_ViewProjection;
+    mat4 u_InverseView;
+    mat4 u_InverseProjection;
+    mat4 u_InverseViewProjection;
+    vec4 u_CameraPosition;
+    vec2 u_ViewportSize;
+    float u_Time;
+    float u_DeltaTime;
 };
 
 layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
 layout(location = 3) in mat4 a_ModelMatrix;
+layout(location = 7) in float a_MaterialIndex;
 
 out vec2 v_TexCoord;
+flat out uint v_MaterialIndex;
+
+// Drawn after the depth prepass, which has to produce the same depth
+invariant gl_Position;
 
 void main()
 {
     v_TexCoord = a_TexCoord;
+    v_MaterialIndex = uint(a_MaterialIndex);
 	
     gl_Position = u_ViewProjection * a_ModelMatrix * vec4(a_Position, 1.0);
 }
 
 #type fragment
 #version 450 core
+#extension GL_ARB_bindless_texture : enable
 
 in vec2 v_TexCoord;
+flat in uint v_MaterialIndex;
 
 layout(location = 0) out vec4 FragColor;
 
+// Parameters of all materials, see MaterialTable
+#ifdef GL_ARB_bindless_texture
+struct MaterialRecord
+{
+    vec4 Color;
+    sampler2D AlbedoMap;
+};
+#else
+struct MaterialRecord
+{
+    vec4 Color;
+    uvec2 AlbedoMap; // Unused without bindless textures
+};
+
 uniform sampler2D u_Textures[32];
-uniform vec4 u_Color;
+#endif
+
+layout(std430, binding = 2) readonly buffer MaterialData
+{
+    MaterialRecord u_Materials[];
+};
 
 void main()
 {
-    FragColor = texture(u_Textures[0], v_TexCoord) * u_Color; 
+    MaterialRecord material = u_Materials[v_MaterialIndex];
+
+#ifdef GL_ARB_bindless_texture
+    FragColor = texture(material.AlbedoMap, v_TexCoord) * material.Color;
+#else
+    FragColor = texture(u_Textures[0], v_TexCoord) * material.Color;
+#endif
 }
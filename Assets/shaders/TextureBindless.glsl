@@ -0,0 +1,107 @@
+// Bindless Texture Shader
+// Texture indices address a table of bindless handles instead of a fixed set of sampler slots
+
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 3) in vec4 a_UVRect;
+layout(location = 4) in float a_TexIndex;
+layout(location = 5) in float a_TilingFactor;
+
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	mat4 u_InverseView;
+	mat4 u_InverseProjection;
+	mat4 u_InverseViewProjection;
+	vec4 u_CameraPosition;
+	vec2 u_ViewportSize;
+	float u_Time;
+	float u_DeltaTime;
+};
+
+out vec4 v_Color;
+out vec2 v_TexCoord; // Sprite coordinates, repeating once per tile
+flat out vec4 v_UVRect;
+flat out int v_TexIndex;
+flat out int v_DistanceField;
+
+void main()
+{
+	v_Color = a_Color;
+	v_TexCoord = a_TexCoord * a_TilingFactor;
+	v_UVRect = a_UVRect;
+	// Signed distance field glyphs store their texture index as -(index + 1)
+	v_DistanceField = a_TexIndex < 0.0 ? 1 : 0;
+	v_TexIndex = int(abs(a_TexIndex)) - v_DistanceField;
+	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 450 core
+#extension GL_ARB_bindless_texture : require
+#extension GL_NV_gpu_shader5 : enable
+#extension GL_ARB_shader_ballot : enable
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in vec4 v_UVRect;
+flat in int v_TexIndex;
+flat in int v_DistanceField;
+
+layout(std430, binding = 1) readonly buffer TextureHandles
+{
+	sampler2D u_TextureHandles[];
+};
+
+// v_TexIndex differs between the quads of a draw, so it isn't dynamically uniform as bindless sampling requires.
+// NV_gpu_shader5 lifts that restriction, otherwise every pass samples with the index of the first active invocation
+// until each invocation had its turn. Renderer2D only loads this shader if one of them is supported.
+vec4 SampleTexture(int index, vec2 texCoord, vec2 gradientX, vec2 gradientY)
+{
+#if defined(GL_NV_gpu_shader5)
+	return textureGrad(u_TextureHandles[index], texCoord, gradientX, gradientY);
+#elif defined(GL_ARB_shader_ballot)
+	vec4 texColor = vec4(1.0);
+	bool sampled = false;
+	while (!sampled)
+	{
+		int uniformIndex = readFirstInvocationARB(index);
+		if (uniformIndex == index)
+		{
+			texColor = textureGrad(u_TextureHandles[uniformIndex], texCoord, gradientX, gradientY);
+			sampled = true;
+		}
+	}
+	return texColor;
+#else
+#error "Bindless texture indices need GL_NV_gpu_shader5 or GL_ARB_shader_ballot"
+#endif
+}
+
+void main()
+{
+	// Tiling repeats the sprite's rect rather than the whole texture, so it happens before mapping into the rect.
+	// fract jumps back at every repeat, the gradients come from the unwrapped coordinates to keep the mip level.
+	vec2 rectSize = v_UVRect.zw - v_UVRect.xy;
+	vec2 texCoord = mix(v_UVRect.xy, v_UVRect.zw, fract(v_TexCoord));
+	vec2 gradientX = dFdx(v_TexCoord) * rectSize;
+	vec2 gradientY = dFdy(v_TexCoord) * rectSize;
+	vec4 texColor = SampleTexture(v_TexIndex, texCoord, gradientX, gradientY);
+
+	// Distance fields store the distance in alpha with the glyph outline at 0.5
+	float smoothing = fwidth(texColor.a); // Outside the branch, derivatives need uniform control flow
+	if (v_DistanceField != 0)
+	{
+		texColor = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - smoothing, 0.5 + smoothing, texColor.a));
+	}
+	color = v_Color * texColor;
+}
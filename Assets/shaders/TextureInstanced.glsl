@@ -0,0 +1,126 @@
+// Instanced Texture Shader
+
+#type vertex
+#version 450 core
+
+// Static unit quad
+layout(location = 0) in vec2 a_LocalPosition;
+layout(location = 1) in vec2 a_LocalTexCoord;
+
+// Per instance
+layout(location = 2) in vec4 a_TransformRow0;
+layout(location = 3) in vec4 a_TransformRow1;
+layout(location = 4) in vec4 a_TransformRow2;
+layout(location = 5) in vec4 a_UVRect;
+layout(location = 6) in vec4 a_Color;
+layout(location = 7) in float a_TexIndex;
+layout(location = 8) in float a_TilingFactor;
+
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	mat4 u_InverseView;
+	mat4 u_InverseProjection;
+	mat4 u_InverseViewProjection;
+	vec4 u_CameraPosition;
+	vec2 u_ViewportSize;
+	float u_Time;
+	float u_DeltaTime;
+};
+
+out vec4 v_Color;
+out vec2 v_TexCoord; // Sprite coordinates, repeating once per tile
+flat out vec4 v_UVRect;
+flat out int v_TexIndex;
+flat out int v_DistanceField;
+
+void main()
+{
+	vec4 localPosition = vec4(a_LocalPosition, 0.0, 1.0);
+	vec3 worldPosition = vec3(dot(a_TransformRow0, localPosition),
+	                          dot(a_TransformRow1, localPosition),
+	                          dot(a_TransformRow2, localPosition));
+
+	v_Color = a_Color;
+	v_TexCoord = a_LocalTexCoord * a_TilingFactor;
+	v_UVRect = a_UVRect;
+	// Signed distance field glyphs store their texture index as -(index + 1)
+	v_DistanceField = a_TexIndex < 0.0 ? 1 : 0;
+	v_TexIndex = int(abs(a_TexIndex)) - v_DistanceField;
+	gl_Position = u_ViewProjection * vec4(worldPosition, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in vec4 v_UVRect;
+flat in int v_TexIndex;
+flat in int v_DistanceField;
+
+uniform sampler2D u_Textures[32];
+
+vec4 SampleTexture(int index, vec2 texCoord, vec2 gradientX, vec2 gradientY)
+{
+	switch (index)
+	{
+		case 0: return textureGrad(u_Textures[0], texCoord, gradientX, gradientY);
+		case 1: return textureGrad(u_Textures[1], texCoord, gradientX, gradientY);
+		case 2: return textureGrad(u_Textures[2], texCoord, gradientX, gradientY);
+		case 3: return textureGrad(u_Textures[3], texCoord, gradientX, gradientY);
+		case 4: return textureGrad(u_Textures[4], texCoord, gradientX, gradientY);
+		case 5: return textureGrad(u_Textures[5], texCoord, gradientX, gradientY);
+		case 6: return textureGrad(u_Textures[6], texCoord, gradientX, gradientY);
+		case 7: return textureGrad(u_Textures[7], texCoord, gradientX, gradientY);
+		case 8: return textureGrad(u_Textures[8], texCoord, gradientX, gradientY);
+		case 9: return textureGrad(u_Textures[9], texCoord, gradientX, gradientY);
+		case 10: return textureGrad(u_Textures[10], texCoord, gradientX, gradientY);
+		case 11: return textureGrad(u_Textures[11], texCoord, gradientX, gradientY);
+		case 12: return textureGrad(u_Textures[12], texCoord, gradientX, gradientY);
+		case 13: return textureGrad(u_Textures[13], texCoord, gradientX, gradientY);
+		case 14: return textureGrad(u_Textures[14], texCoord, gradientX, gradientY);
+		case 15: return textureGrad(u_Textures[15], texCoord, gradientX, gradientY);
+		case 16: return textureGrad(u_Textures[16], texCoord, gradientX, gradientY);
+		case 17: return textureGrad(u_Textures[17], texCoord, gradientX, gradientY);
+		case 18: return textureGrad(u_Textures[18], texCoord, gradientX, gradientY);
+		case 19: return textureGrad(u_Textures[19], texCoord, gradientX, gradientY);
+		case 20: return textureGrad(u_Textures[20], texCoord, gradientX, gradientY);
+		case 21: return textureGrad(u_Textures[21], texCoord, gradientX, gradientY);
+		case 22: return textureGrad(u_Textures[22], texCoord, gradientX, gradientY);
+		case 23: return textureGrad(u_Textures[23], texCoord, gradientX, gradientY);
+		case 24: return textureGrad(u_Textures[24], texCoord, gradientX, gradientY);
+		case 25: return textureGrad(u_Textures[25], texCoord, gradientX, gradientY);
+		case 26: return textureGrad(u_Textures[26], texCoord, gradientX, gradientY);
+		case 27: return textureGrad(u_Textures[27], texCoord, gradientX, gradientY);
+		case 28: return textureGrad(u_Textures[28], texCoord, gradientX, gradientY);
+		case 29: return textureGrad(u_Textures[29], texCoord, gradientX, gradientY);
+		case 30: return textureGrad(u_Textures[30], texCoord, gradientX, gradientY);
+		case 31: return textureGrad(u_Textures[31], texCoord, gradientX, gradientY);
+	}
+	return vec4(1.0);
+}
+
+void main()
+{
+	// Tiling repeats the sprite's rect rather than the whole texture, so it happens before mapping into the rect.
+	// fract jumps back at every repeat, the gradients come from the unwrapped coordinates to keep the mip level.
+	vec2 rectSize = v_UVRect.zw - v_UVRect.xy;
+	vec2 texCoord = mix(v_UVRect.xy, v_UVRect.zw, fract(v_TexCoord));
+	vec2 gradientX = dFdx(v_TexCoord) * rectSize;
+	vec2 gradientY = dFdy(v_TexCoord) * rectSize;
+	vec4 texColor = SampleTexture(v_TexIndex, texCoord, gradientX, gradientY);
+
+	// Distance fields store the distance in alpha with the glyph outline at 0.5
+	float smoothing = fwidth(texColor.a); // Outside the branch, derivatives need uniform control flow
+	if (v_DistanceField != 0)
+	{
+		texColor = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - smoothing, 0.5 + smoothing, texColor.a));
+	}
+	color = v_Color * texColor;
+}
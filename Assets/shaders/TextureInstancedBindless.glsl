@@ -0,0 +1,117 @@
+// Instanced Bindless Texture Shader
+
+#type vertex
+#version 450 core
+
+// Static unit quad
+layout(location = 0) in vec2 a_LocalPosition;
+layout(location = 1) in vec2 a_LocalTexCoord;
+
+// Per instance
+layout(location = 2) in vec4 a_TransformRow0;
+layout(location = 3) in vec4 a_TransformRow1;
+layout(location = 4) in vec4 a_TransformRow2;
+layout(location = 5) in vec4 a_UVRect;
+layout(location = 6) in vec4 a_Color;
+layout(location = 7) in float a_TexIndex;
+layout(location = 8) in float a_TilingFactor;
+
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	mat4 u_InverseView;
+	mat4 u_InverseProjection;
+	mat4 u_InverseViewProjection;
+	vec4 u_CameraPosition;
+	vec2 u_ViewportSize;
+	float u_Time;
+	float u_DeltaTime;
+};
+
+out vec4 v_Color;
+out vec2 v_TexCoord; // Sprite coordinates, repeating once per tile
+flat out vec4 v_UVRect;
+flat out int v_TexIndex;
+flat out int v_DistanceField;
+
+void main()
+{
+	vec4 localPosition = vec4(a_LocalPosition, 0.0, 1.0);
+	vec3 worldPosition = vec3(dot(a_TransformRow0, localPosition),
+	                          dot(a_TransformRow1, localPosition),
+	                          dot(a_TransformRow2, localPosition));
+
+	v_Color = a_Color;
+	v_TexCoord = a_LocalTexCoord * a_TilingFactor;
+	v_UVRect = a_UVRect;
+	// Signed distance field glyphs store their texture index as -(index + 1)
+	v_DistanceField = a_TexIndex < 0.0 ? 1 : 0;
+	v_TexIndex = int(abs(a_TexIndex)) - v_DistanceField;
+	gl_Position = u_ViewProjection * vec4(worldPosition, 1.0);
+}
+
+#type fragment
+#version 450 core
+#extension GL_ARB_bindless_texture : require
+#extension GL_NV_gpu_shader5 : enable
+#extension GL_ARB_shader_ballot : enable
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in vec4 v_UVRect;
+flat in int v_TexIndex;
+flat in int v_DistanceField;
+
+layout(std430, binding = 1) readonly buffer TextureHandles
+{
+	sampler2D u_TextureHandles[];
+};
+
+// v_TexIndex differs between the quads of a draw, so it isn't dynamically uniform as bindless sampling requires.
+// NV_gpu_shader5 lifts that restriction, otherwise every pass samples with the index of the first active invocation
+// until each invocation had its turn. Renderer2D only loads this shader if one of them is supported.
+vec4 SampleTexture(int index, vec2 texCoord, vec2 gradientX, vec2 gradientY)
+{
+#if defined(GL_NV_gpu_shader5)
+	return textureGrad(u_TextureHandles[index], texCoord, gradientX, gradientY);
+#elif defined(GL_ARB_shader_ballot)
+	vec4 texColor = vec4(1.0);
+	bool sampled = false;
+	while (!sampled)
+	{
+		int uniformIndex = readFirstInvocationARB(index);
+		if (uniformIndex == index)
+		{
+			texColor = textureGrad(u_TextureHandles[uniformIndex], texCoord, gradientX, gradientY);
+			sampled = true;
+		}
+	}
+	return texColor;
+#else
+#error "Bindless texture indices need GL_NV_gpu_shader5 or GL_ARB_shader_ballot"
+#endif
+}
+
+void main()
+{
+	// Tiling repeats the sprite's rect rather than the whole texture, so it happens before mapping into the rect.
+	// fract jumps back at every repeat, the gradients come from the unwrapped coordinates to keep the mip level.
+	vec2 rectSize = v_UVRect.zw - v_UVRect.xy;
+	vec2 texCoord = mix(v_UVRect.xy, v_UVRect.zw, fract(v_TexCoord));
+	vec2 gradientX = dFdx(v_TexCoord) * rectSize;
+	vec2 gradientY = dFdy(v_TexCoord) * rectSize;
+	vec4 texColor = SampleTexture(v_TexIndex, texCoord, gradientX, gradientY);
+
+	// Distance fields store the distance in alpha with the glyph outline at 0.5
+	float smoothing = fwidth(texColor.a); // Outside the branch, derivatives need uniform control flow
+	if (v_DistanceField != 0)
+	{
+		texColor = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - smoothing, 0.5 + smoothing, texColor.a));
+	}
+	color = v_Color * texColor;
+}
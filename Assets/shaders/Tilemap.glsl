@@ -0,0 +1,47 @@
+// Tilemap chunk shader, tile positions are relative to the tilemap
+
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec2 a_TexCoord;
+
+// Per-view constants shared by every shader, see ViewData
+layout(std140, binding = 0) uniform ViewData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	mat4 u_InverseView;
+	mat4 u_InverseProjection;
+	mat4 u_InverseViewProjection;
+	vec4 u_CameraPosition;
+	vec2 u_ViewportSize;
+	float u_Time;
+	float u_DeltaTime;
+};
+
+uniform mat4 u_Transform;
+
+out vec2 v_TexCoord;
+
+void main()
+{
+	v_TexCoord = a_TexCoord;
+	gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 0.0, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform vec4 u_Color;
+uniform sampler2D u_Tileset;
+
+void main()
+{
+	color = texture(u_Tileset, v_TexCoord) * u_Color;
+}
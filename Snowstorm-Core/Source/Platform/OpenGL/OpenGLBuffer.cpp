@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "OpenGLBuffer.h"
 
+#include <cstring>
+
 #include <GL/glew.h>
 
 namespace Snowstorm
@@ -64,6 +66,131 @@ namespace Snowstorm
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
+	//////////////////////////////////////////////////////////////////////////////
+	// StreamingVertexBuffer /////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////
+
+	OpenGLStreamingVertexBuffer::OpenGLStreamingVertexBuffer(const uint32_t regionSize)
+		: m_RegionSize(regionSize)
+	{
+		SS_PROFILE_FUNCTION();
+
+		constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const GLsizeiptr size = static_cast<GLsizeiptr>(regionSize) * RegionCount;
+
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferStorage(m_RendererID, size, nullptr, flags);
+		m_MappedData = static_cast<uint8_t*>(glMapNamedBufferRange(m_RendererID, 0, size, flags));
+
+		SS_CORE_ASSERT(m_MappedData, "Failed to map streaming vertex buffer!");
+	}
+
+	OpenGLStreamingVertexBuffer::~OpenGLStreamingVertexBuffer()
+	{
+		SS_PROFILE_FUNCTION();
+
+		for (void* fence : m_RegionFences)
+		{
+			if (fence)
+			{
+				glDeleteSync(static_cast<GLsync>(fence));
+			}
+		}
+
+		glUnmapNamedBuffer(m_RendererID);
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLStreamingVertexBuffer::SetData(const void* data, const uint32_t size)
+	{
+		SetSubData(data, size, 0);
+	}
+
+	void OpenGLStreamingVertexBuffer::SetSubData(const void* data, const uint32_t size, const uint32_t offset)
+	{
+		SS_PROFILE_FUNCTION();
+
+		SS_CORE_ASSERT(offset + size <= m_RegionSize, "Write exceeds streaming buffer region!");
+		std::memcpy(m_MappedData + m_Region * m_RegionSize + offset, data, size);
+	}
+
+	void OpenGLStreamingVertexBuffer::Bind() const
+	{
+		SS_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+	}
+
+	void OpenGLStreamingVertexBuffer::Unbind() const
+	{
+		SS_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void OpenGLStreamingVertexBuffer::BeginFrame()
+	{
+		SS_PROFILE_FUNCTION();
+
+		m_Region = (m_Region + 1) % RegionCount;
+		m_RegionHead = 0;
+
+		void*& fence = m_RegionFences[m_Region];
+		if (!fence)
+		{
+			return;
+		}
+
+		// Only blocks if the CPU runs more than RegionCount - 1 frames ahead of the GPU
+		constexpr GLuint64 timeout = 1'000'000; // 1 ms
+		while (true)
+		{
+			const GLenum result = glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+			{
+				break;
+			}
+
+			if (result == GL_WAIT_FAILED)
+			{
+				SS_CORE_ERROR("Waiting on streaming vertex buffer region failed!");
+				break;
+			}
+		}
+
+		glDeleteSync(static_cast<GLsync>(fence));
+		fence = nullptr;
+	}
+
+	void OpenGLStreamingVertexBuffer::EndFrame()
+	{
+		SS_PROFILE_FUNCTION();
+
+		void*& fence = m_RegionFences[m_Region];
+		if (fence)
+		{
+			glDeleteSync(static_cast<GLsync>(fence));
+		}
+
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	StreamingVertexBuffer::Allocation OpenGLStreamingVertexBuffer::Allocate(const uint32_t size, uint32_t alignment)
+	{
+		alignment = std::max(alignment, 1u);
+
+		const uint32_t regionStart = m_Region * m_RegionSize;
+		const uint32_t offset = (regionStart + m_RegionHead + alignment - 1) / alignment * alignment;
+
+		if (offset + size > regionStart + m_RegionSize)
+		{
+			return {};
+		}
+
+		m_RegionHead = offset + size - regionStart;
+		return {m_MappedData + offset, offset};
+	}
+
 	//////////////////////////////////////////////////////////////////////////////
 	// IndexBuffer ///////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,46 @@ namespace Snowstorm
 		BufferLayout m_Layout;
 	};
 
+	class OpenGLStreamingVertexBuffer final : public StreamingVertexBuffer
+	{
+	public:
+		explicit OpenGLStreamingVertexBuffer(uint32_t regionSize);
+		~OpenGLStreamingVertexBuffer() override;
+
+		OpenGLStreamingVertexBuffer(const OpenGLStreamingVertexBuffer& other) = delete;
+		OpenGLStreamingVertexBuffer(OpenGLStreamingVertexBuffer&& other) = delete;
+		OpenGLStreamingVertexBuffer& operator=(const OpenGLStreamingVertexBuffer& other) = delete;
+		OpenGLStreamingVertexBuffer& operator=(OpenGLStreamingVertexBuffer&& other) = delete;
+
+		void SetData(const void* data, uint32_t size) override;
+		void SetSubData(const void* data, uint32_t size, uint32_t offset) override;
+
+		void Bind() const override;
+		void Unbind() const override;
+
+		const BufferLayout& GetLayout() const override { return m_Layout; }
+		void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+
+		void BeginFrame() override;
+		void EndFrame() override;
+
+		Allocation Allocate(uint32_t size, uint32_t alignment) override;
+
+		uint32_t GetRegionSize() const override { return m_RegionSize; }
+
+	private:
+		uint32_t m_RendererID;
+		BufferLayout m_Layout;
+
+		uint8_t* m_MappedData = nullptr;
+		uint32_t m_RegionSize;
+
+		uint32_t m_Region = 0;
+		uint32_t m_RegionHead = 0;
+
+		std::array<void*, RegionCount> m_RegionFences{}; // GLsync per region
+	};
+
 	class OpenGLIndexBuffer final : public IndexBuffer
 	{
 	public:
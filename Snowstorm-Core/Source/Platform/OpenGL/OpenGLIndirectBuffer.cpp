@@ -0,0 +1,39 @@
+#include "pch.h"
+
+#include "OpenGLIndirectBuffer.hpp"
+
+#include <GL/glew.h>
+
+namespace Snowstorm
+{
+	OpenGLIndirectBuffer::OpenGLIndirectBuffer(const uint32_t size)
+		: m_Size(size)
+	{
+		glGenBuffers(1, &m_RendererID);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	OpenGLIndirectBuffer::~OpenGLIndirectBuffer()
+	{
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::SetData(const void* data, const uint32_t size, const uint32_t offset)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+
+		if (offset + size > m_Size)
+		{
+			m_Size = std::max(offset + size, m_Size * 2);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW);
+		}
+
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, offset, size, data);
+	}
+
+	void OpenGLIndirectBuffer::Bind() const
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+	}
+}
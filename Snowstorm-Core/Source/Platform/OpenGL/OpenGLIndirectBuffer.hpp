@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Snowstorm/Render/IndirectBuffer.hpp"
+
+namespace Snowstorm
+{
+	class OpenGLIndirectBuffer final : public IndirectBuffer
+	{
+	public:
+		explicit OpenGLIndirectBuffer(uint32_t size);
+		~OpenGLIndirectBuffer() override;
+
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+		void Bind() const override;
+
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Size;
+	};
+}
@@ -0,0 +1,194 @@
+#include "pch.h"
+#include "OpenGLProgramCache.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+#include <GL/glew.h>
+
+static_assert(std::is_same_v<GLenum, uint32_t>, "Shader sources keyed by GLenum are passed to GetKey as they are");
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Bumped whenever the file layout changes
+		constexpr uint32_t FormatVersion = 1;
+		constexpr uint32_t Magic = 0x50475353; // "SSGP"
+
+		struct FileHeader
+		{
+			uint32_t Magic = 0;
+			uint32_t Version = 0;
+			uint64_t Key = 0;
+			uint32_t BinaryFormat = 0;
+			uint32_t BinarySize = 0;
+		};
+
+		// FNV-1a, stable across runs and platforms unlike std::hash
+		uint64_t Hash(const std::string_view data, uint64_t hash = 0xcbf29ce484222325ull)
+		{
+			for (const char c : data)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= 0x100000001b3ull;
+			}
+			return hash;
+		}
+
+		std::string GetString(const GLenum name)
+		{
+			const auto* string = reinterpret_cast<const char*>(glGetString(name));
+			return string ? string : "";
+		}
+
+		// A driver update may change what it accepts, so its identity is part of every key
+		const std::string& GetDriverString()
+		{
+			static const std::string driver = GetString(GL_VENDOR) + '\n' + GetString(GL_RENDERER) + '\n' +
+				GetString(GL_VERSION);
+			return driver;
+		}
+
+		std::filesystem::path GetEntryPath(const uint64_t key)
+		{
+			std::ostringstream fileName;
+			fileName << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+			return std::filesystem::path(OpenGLProgramCache::Directory) / fileName.str();
+		}
+	}
+
+	bool OpenGLProgramCache::IsSupported()
+	{
+		static const bool supported = []
+		{
+			GLint formatCount = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+			return formatCount > 0;
+		}();
+		return supported;
+	}
+
+	uint64_t OpenGLProgramCache::GetKey(const std::unordered_map<uint32_t, std::string>& shaderSources)
+	{
+		// The map's order isn't stable, stages are hashed in the order of their type instead
+		std::vector<uint32_t> types;
+		for (const auto& [type, source] : shaderSources)
+		{
+			types.push_back(type);
+		}
+		std::ranges::sort(types);
+
+		uint64_t key = Hash(GetDriverString());
+		for (const uint32_t type : types)
+		{
+			const std::string& source = shaderSources.at(type);
+			key = Hash(std::string_view(reinterpret_cast<const char*>(&type), sizeof(type)), key);
+			key = Hash(std::to_string(source.size()), key);
+			key = Hash(source, key);
+		}
+
+		return key;
+	}
+
+	uint32_t OpenGLProgramCache::Load(const uint64_t key)
+	{
+		SS_PROFILE_FUNCTION();
+
+		if (!IsSupported())
+		{
+			return 0;
+		}
+
+		std::ifstream in(GetEntryPath(key), std::ios::in | std::ios::binary);
+		if (!in)
+		{
+			return 0;
+		}
+
+		FileHeader header;
+		in.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!in || header.Magic != Magic || header.Version != FormatVersion || header.Key != key)
+		{
+			return 0;
+		}
+
+		std::vector<char> binary(header.BinarySize);
+		in.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+		if (!in)
+		{
+			return 0;
+		}
+
+		const GLuint program = glCreateProgram();
+		glProgramBinary(program, header.BinaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+		// Drivers reject binaries of other versions or formats through the link status, the sources are compiled then
+		GLint isLinked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		if (isLinked == GL_FALSE)
+		{
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		return program;
+	}
+
+	void OpenGLProgramCache::Store(const uint64_t key, const uint32_t program)
+	{
+		SS_PROFILE_FUNCTION();
+
+		if (!IsSupported())
+		{
+			return;
+		}
+
+		GLint size = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+		if (size <= 0)
+		{
+			return;
+		}
+
+		FileHeader header;
+		header.Magic = Magic;
+		header.Version = FormatVersion;
+		header.Key = key;
+
+		std::vector<char> binary(size);
+		GLenum binaryFormat = 0;
+		glGetProgramBinary(program, size, &size, &binaryFormat, binary.data());
+		header.BinaryFormat = binaryFormat;
+		header.BinarySize = static_cast<uint32_t>(size);
+
+		std::error_code error;
+		std::filesystem::create_directories(Directory, error);
+
+		// Written next to the entry and renamed over it, so another instance never reads half a file
+		const std::filesystem::path path = GetEntryPath(key);
+		std::filesystem::path temporaryPath = path;
+		temporaryPath += ".tmp";
+
+		{
+			std::ofstream out(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(binary.data(), size);
+
+			if (!out)
+			{
+				SS_CORE_WARN("Could not write program binary '{0}'", temporaryPath.string());
+				return;
+			}
+		}
+
+		std::filesystem::rename(temporaryPath, path, error);
+		if (error)
+		{
+			SS_CORE_WARN("Could not write program binary '{0}': {1}", path.string(), error.message());
+			std::filesystem::remove(temporaryPath, error);
+		}
+	}
+}
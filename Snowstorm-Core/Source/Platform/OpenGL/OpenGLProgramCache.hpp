@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace Snowstorm
+{
+	// Keeps linked program binaries on disk so later runs skip compiling and linking
+	// Entries are keyed by the stage sources and the driver, a binary the driver refuses anyway is recompiled and
+	// replaced. Programs have to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set to be stored.
+	class OpenGLProgramCache
+	{
+	public:
+		static constexpr auto Directory = "cache/shaders";
+
+		// False when the driver doesn't support any binary format, nothing is loaded or stored then
+		[[nodiscard]] static bool IsSupported();
+
+		// shaderSources maps stage types (GLenum) to their source
+		[[nodiscard]] static uint64_t GetKey(const std::unordered_map<uint32_t, std::string>& shaderSources);
+
+		// Returns a linked program, or 0 when there is no usable binary for key
+		[[nodiscard]] static uint32_t Load(uint64_t key);
+
+		static void Store(uint64_t key, uint32_t program);
+	};
+}
@@ -25,6 +25,26 @@ namespace Snowstorm
 
 		// Enable seamless cubemap filtering (Optional)
 		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+		GLint maxTextureUnits = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+		m_Capabilities.MaxTextureSlots = static_cast<uint32_t>(maxTextureUnits);
+
+		// Sprites index the handle table per quad, which needs either extension to be sampled correctly
+		m_Capabilities.BindlessTextures = GLEW_ARB_bindless_texture && (GLEW_NV_gpu_shader5 || GLEW_ARB_shader_ballot);
+
+		// Lets shaders compile and link on driver threads, so a recompile doesn't stall the frame
+		if (GLEW_KHR_parallel_shader_compile)
+		{
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF); // As many as the driver sees fit
+		}
+
+		GLint uniformBufferAlignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferAlignment);
+		m_Capabilities.UniformBufferAlignment = static_cast<uint32_t>(uniformBufferAlignment);
+
+		SS_CORE_INFO("OpenGL capabilities: {0} texture slots, bindless textures {1}", m_Capabilities.MaxTextureSlots,
+		             m_Capabilities.BindlessTextures ? "supported" : "not supported");
 	}
 
 	void OpenGLRendererAPI::SetViewport(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height)
@@ -42,18 +62,39 @@ namespace Snowstorm
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
-	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, const uint32_t indexCount)
+	void OpenGLRendererAPI::SetDepthFunction(const DepthFunction function)
+	{
+		glDepthFunc(function == DepthFunction::LessEqual ? GL_LEQUAL : GL_LESS);
+	}
+
+	void OpenGLRendererAPI::SetWriteMask(const bool color, const bool depth)
+	{
+		const GLboolean colorMask = color ? GL_TRUE : GL_FALSE;
+		glColorMask(colorMask, colorMask, colorMask, colorMask);
+		glDepthMask(depth ? GL_TRUE : GL_FALSE);
+	}
+
+	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, const uint32_t indexCount,
+	                                    const uint32_t baseVertex)
 	{
 		const uint32_t count = indexCount == 0 ? vertexArray->GetIndexBuffer()->GetCount() : indexCount;
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, static_cast<GLint>(baseVertex));
 	}
 
 	void OpenGLRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, const uint32_t indexCount,
-	                                             const uint32_t instanceCount)
+	                                             const uint32_t instanceCount, const uint32_t baseInstance,
+	                                             const uint32_t baseVertex)
 	{
 		const uint32_t count = indexCount == 0 ? vertexArray->GetIndexBuffer()->GetCount() : indexCount;
-		glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, instanceCount);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, instanceCount,
+		                                              static_cast<GLint>(baseVertex), baseInstance);
+	}
+
+	void OpenGLRendererAPI::DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands,
+	                                            const uint32_t drawCount, const uint32_t offset)
+	{
+		commands->Bind();
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)),
+		                            static_cast<GLsizei>(drawCount), sizeof(DrawIndexedIndirectCommand));
 	}
 }
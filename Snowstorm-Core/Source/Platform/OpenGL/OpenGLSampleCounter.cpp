@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "OpenGLSampleCounter.hpp"
+
+#include <GL/glew.h>
+
+namespace Snowstorm
+{
+	OpenGLSampleCounter::OpenGLSampleCounter()
+	{
+		glGenQueries(QueryCount, m_Queries.data());
+	}
+
+	OpenGLSampleCounter::~OpenGLSampleCounter()
+	{
+		glDeleteQueries(QueryCount, m_Queries.data());
+	}
+
+	bool OpenGLSampleCounter::Begin()
+	{
+		SS_CORE_ASSERT(!m_Active, "Sample counter already begun!");
+		if (m_Begun - m_Popped == QueryCount)
+		{
+			return false;
+		}
+
+		glBeginQuery(GL_SAMPLES_PASSED, m_Queries[m_Begun % QueryCount]);
+		m_Active = true;
+		return true;
+	}
+
+	void OpenGLSampleCounter::End()
+	{
+		if (!m_Active)
+		{
+			return;
+		}
+
+		glEndQuery(GL_SAMPLES_PASSED);
+		m_Begun++;
+		m_Active = false;
+	}
+
+	std::optional<uint64_t> OpenGLSampleCounter::PopResult()
+	{
+		if (m_Popped == m_Begun)
+		{
+			return std::nullopt;
+		}
+
+		const uint32_t query = m_Queries[m_Popped % QueryCount];
+
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			return std::nullopt;
+		}
+
+		GLuint64 samples = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &samples);
+		m_Popped++;
+		return samples;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <array>
+
+#include "Snowstorm/Render/SampleCounter.hpp"
+
+namespace Snowstorm
+{
+	class OpenGLSampleCounter final : public SampleCounter
+	{
+	public:
+		OpenGLSampleCounter();
+		~OpenGLSampleCounter() override;
+
+		bool Begin() override;
+		void End() override;
+
+		std::optional<uint64_t> PopResult() override;
+
+	private:
+		// Enough for several frames of scenes to be in flight
+		static constexpr uint32_t QueryCount = 16;
+
+		std::array<uint32_t, QueryCount> m_Queries{};
+		uint32_t m_Begun = 0; // Queries begun so far, the next one uses m_Begun % QueryCount
+		uint32_t m_Popped = 0;
+		bool m_Active = false;
+	};
+}
@@ -5,6 +5,8 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include "OpenGLProgramCache.hpp"
+
 namespace Snowstorm
 {
 	namespace
@@ -20,9 +22,73 @@ namespace Snowstorm
 				return GL_FRAGMENT_SHADER;
 			}
 
-			SS_CORE_ASSERT(false, "Unknown shader type!");
 			return 0;
 		}
+
+		std::string GetShaderLog(const GLuint shader)
+		{
+			GLint length = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+
+			// The length includes the null character
+			std::string log(std::max(length, 1), '\0');
+			glGetShaderInfoLog(shader, length, &length, log.data());
+			log.resize(length);
+			return log;
+		}
+
+		std::string GetProgramLog(const GLuint program)
+		{
+			GLint length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+
+			std::string log(std::max(length, 1), '\0');
+			glGetProgramInfoLog(program, length, &length, log.data());
+			log.resize(length);
+			return log;
+		}
+
+		bool IsOpenGLSamplerType(const GLenum type)
+		{
+			switch (type)
+			{
+			case GL_SAMPLER_1D:
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_2D_SHADOW:
+			case GL_SAMPLER_2D_MULTISAMPLE:
+			case GL_INT_SAMPLER_2D:
+			case GL_UNSIGNED_INT_SAMPLER_2D: return true;
+			default: return false;
+			}
+		}
+
+		// Samplers are set like ints, types without a ShaderDataType map to None
+		ShaderDataType ShaderDataTypeFromOpenGLType(const GLenum type)
+		{
+			if (IsOpenGLSamplerType(type))
+			{
+				return ShaderDataType::Int;
+			}
+
+			switch (type)
+			{
+			case GL_FLOAT: return ShaderDataType::Float;
+			case GL_FLOAT_VEC2: return ShaderDataType::Float2;
+			case GL_FLOAT_VEC3: return ShaderDataType::Float3;
+			case GL_FLOAT_VEC4: return ShaderDataType::Float4;
+			case GL_FLOAT_MAT3: return ShaderDataType::Mat3;
+			case GL_FLOAT_MAT4: return ShaderDataType::Mat4;
+			case GL_INT: return ShaderDataType::Int;
+			case GL_INT_VEC2: return ShaderDataType::Int2;
+			case GL_INT_VEC3: return ShaderDataType::Int3;
+			case GL_INT_VEC4: return ShaderDataType::Int4;
+			case GL_BOOL: return ShaderDataType::Bool;
+			default: return ShaderDataType::None;
+			}
+		}
 	}
 
 	OpenGLShader::OpenGLShader(const std::string& filepath)
@@ -31,8 +97,7 @@ namespace Snowstorm
 		SS_PROFILE_FUNCTION();
 
 		const std::string source = ReadFile(filepath);
-		auto shaderSources = PreProcess(source);
-		Compile(shaderSources);
+		CompileNow(PreProcess(source));
 	}
 
 	OpenGLShader::OpenGLShader(std::string filepath,
@@ -44,13 +109,18 @@ namespace Snowstorm
 		std::unordered_map<GLenum, std::string> sources;
 		sources[GL_VERTEX_SHADER] = vertexSrc;
 		sources[GL_FRAGMENT_SHADER] = fragmentSrc;
-		Compile(sources);
+		CompileNow(sources);
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
 		SS_PROFILE_FUNCTION();
 
+		if (m_PendingProgram)
+		{
+			DiscardProgram(*m_PendingProgram);
+		}
+
 		glDeleteProgram(m_RendererID);
 	}
 
@@ -86,18 +156,27 @@ namespace Snowstorm
 		size_t pos = source.find(typeToken, 0);
 		while (pos != std::string::npos)
 		{
+			// Stages that can't be parsed are left out, which fails the link with a message instead of asserting
 			const size_t eol = source.find_first_of("\r\n", pos);
-			SS_CORE_ASSERT(eol != std::string::npos, "Syntax error");
+			const size_t nextLinePos = source.find_first_not_of("\r\n", eol);
+			if (nextLinePos == std::string::npos)
+			{
+				SS_CORE_ERROR("Shader stage without source");
+				break;
+			}
+
 			const size_t begin = pos + typeTokenLength + 1;
-			std::string type = source.substr(begin, eol - begin);
-			SS_CORE_ASSERT(ShaderTypeFromString(type), "Invalid shader type specifier!");
+			const std::string type = source.substr(begin, eol - begin);
 
-			const size_t nextLinePos = source.find_first_not_of("\r\n", eol);
 			pos = source.find(typeToken, nextLinePos);
-			shaderSources[ShaderTypeFromString(type)] = source.substr(nextLinePos,
-			                                                          pos - (nextLinePos == std::string::npos
-				                                                          ? source.size() - 1
-				                                                          : nextLinePos));
+			if (const GLenum stage = ShaderTypeFromString(type))
+			{
+				shaderSources[stage] = source.substr(nextLinePos, pos - nextLinePos);
+			}
+			else
+			{
+				SS_CORE_ERROR("Invalid shader type specifier '{0}'", type);
+			}
 		}
 
 		return shaderSources;
@@ -105,192 +184,275 @@ namespace Snowstorm
 
 	void OpenGLShader::Compile()
 	{
+		SS_PROFILE_FUNCTION();
+
+		if (m_PendingProgram)
+		{
+			DiscardProgram(*m_PendingProgram);
+		}
+
 		const std::string source = ReadFile(m_Filepath);
-		auto shaderSources = PreProcess(source);
-		Compile(shaderSources);
+		m_PendingProgram = BeginCompile(PreProcess(source));
+	}
+
+	std::optional<ShaderCompileResult> OpenGLShader::PollRecompile()
+	{
+		if (!m_PendingProgram || !IsCompileComplete(*m_PendingProgram))
+		{
+			return std::nullopt;
+		}
+
+		const PendingProgram pending = std::move(*m_PendingProgram);
+		m_PendingProgram.reset();
+
+		return FinishCompile(pending);
+	}
+
+	void OpenGLShader::CompileNow(const std::unordered_map<GLenum, std::string>& shaderSources)
+	{
+		// Without a program the shader draws nothing, which beats taking the application down over a typo
+		if (const ShaderCompileResult result = FinishCompile(BeginCompile(shaderSources)); !result.Succeeded)
+		{
+			SS_CORE_ERROR("Could not compile shader '{0}':\n{1}", m_Filepath, result.Log);
+		}
 	}
 
-	void OpenGLShader::Compile(std::unordered_map<GLenum, std::string>& shaderSources)
+	OpenGLShader::PendingProgram OpenGLShader::BeginCompile(
+		const std::unordered_map<GLenum, std::string>& shaderSources)
 	{
 		SS_PROFILE_FUNCTION();
 
-		const GLuint program = glCreateProgram();
-		SS_CORE_ASSERT(shaderSources.size() <= 2, "We only support 2 shaders for now");
-		std::array<GLenum, 2> glShaderIDs;
-		int glShaderIDIndex = 0;
+		PendingProgram pending;
+		pending.CacheKey = OpenGLProgramCache::GetKey(shaderSources);
+		pending.Program = OpenGLProgramCache::Load(pending.CacheKey);
+		if (pending.Program)
+		{
+			pending.Cached = true;
+			return pending;
+		}
+
+		pending.Program = glCreateProgram();
 		for (const auto& [type, source] : shaderSources)
 		{
 			const GLuint shader = glCreateShader(type);
 
 			const GLchar* sourceCStr = source.c_str();
 			glShaderSource(shader, 1, &sourceCStr, nullptr);
-
 			glCompileShader(shader);
 
-			GLint isCompiled = 0;
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
-			if (isCompiled == GL_FALSE)
-			{
-				GLint maxLength = 0;
-				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+			glAttachShader(pending.Program, shader);
+			pending.Shaders.push_back(shader);
+		}
 
-				std::vector<GLchar> infoLog(maxLength);
-				glGetShaderInfoLog(shader, maxLength, &maxLength, infoLog.data());
+		// With parallel compilation neither the compiles nor the link wait for the driver. A stage that doesn't
+		// compile fails the link, so its status is only looked at once the link is done.
+		glProgramParameteri(pending.Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(pending.Program);
 
-				glDeleteShader(shader);
+		return pending;
+	}
 
-				SS_CORE_ERROR("{0}", infoLog.data());
-				SS_CORE_ASSERT(false, "Shader compilation failure!");
-				break;
+	bool OpenGLShader::IsCompileComplete(const PendingProgram& pending)
+	{
+		// Without the extension the first status query waits for the driver anyway
+		if (pending.Cached || !GLEW_KHR_parallel_shader_compile)
+		{
+			return true;
+		}
+
+		GLint isComplete = GL_FALSE;
+		glGetProgramiv(pending.Program, GL_COMPLETION_STATUS_KHR, &isComplete);
+		return isComplete == GL_TRUE;
+	}
+
+	ShaderCompileResult OpenGLShader::FinishCompile(const PendingProgram& pending)
+	{
+		SS_PROFILE_FUNCTION();
+
+		ShaderCompileResult result;
+
+		GLint isLinked = GL_FALSE;
+		glGetProgramiv(pending.Program, GL_LINK_STATUS, &isLinked);
+		result.Succeeded = isLinked == GL_TRUE;
+
+		if (!result.Succeeded)
+		{
+			// The stage logs point at the broken line, the link log alone usually doesn't
+			for (const GLuint shader : pending.Shaders)
+			{
+				GLint isCompiled = GL_FALSE;
+				glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+				if (isCompiled == GL_FALSE)
+				{
+					result.Log += GetShaderLog(shader);
+				}
 			}
+			result.Log += GetProgramLog(pending.Program);
 
-			glAttachShader(program, shader);
-			glShaderIDs[glShaderIDIndex++] = shader;
+			DiscardProgram(pending);
+			return result;
 		}
 
-		// Link our program
-		glLinkProgram(program);
+		if (!pending.Cached)
+		{
+			OpenGLProgramCache::Store(pending.CacheKey, pending.Program);
+		}
 
-		// Note the different functions here: glGetProgram* instead of glGetShader*.
-		GLint isLinked = 0;
-		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
-		if (isLinked == GL_FALSE)
+		for (const GLuint shader : pending.Shaders)
 		{
-			GLint maxLength = 0;
-			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
-
-			// The maxLength includes the NULL character
-			std::vector<GLchar> infoLog(maxLength);
-			glGetProgramInfoLog(program, maxLength, &maxLength, infoLog.data());
-
-			// We don't need the program anymore.
-			glDeleteProgram(program);
-			// Don't leak shaders either.
-			for (const auto id : glShaderIDs)
-				glDeleteShader(id);
-
-			SS_CORE_ERROR("{0}", infoLog.data());
-			SS_CORE_ASSERT(false, "Shader link failure!")
-			return;
+			glDetachShader(pending.Program, shader);
+			glDeleteShader(shader);
 		}
 
-		for (const auto id : glShaderIDs)
-			glDetachShader(program, id);
+		// The previous program was in use until now and is only released once the new one linked
+		glDeleteProgram(m_RendererID);
+		m_RendererID = pending.Program;
 
-		m_RendererID = program;
-	}
+		Reflect();
 
+		return result;
+	}
 
-	void OpenGLShader::Bind() const
+	void OpenGLShader::DiscardProgram(const PendingProgram& pending)
 	{
-		SS_PROFILE_FUNCTION();
-
-		glUseProgram(m_RendererID);
+		for (const GLuint shader : pending.Shaders)
+		{
+			glDeleteShader(shader);
+		}
+		glDeleteProgram(pending.Program);
 	}
 
-	void OpenGLShader::Unbind() const
+	void OpenGLShader::Reflect()
 	{
 		SS_PROFILE_FUNCTION();
 
-		// Used for debugging purposes, do not need to unbind before binding another shader
-		glUseProgram(0);
-	}
+		ShaderReflection reflection;
+		std::vector<GLchar> name;
 
-	void OpenGLShader::UploadUniform(const std::string& name, const int value)
-	{
-		SS_PROFILE_FUNCTION();
+		const auto getName = [&](const GLenum programInterface, const GLuint index, const GLint length)
+		{
+			name.resize(length);
+			glGetProgramResourceName(m_RendererID, programInterface, index, length, nullptr, name.data());
 
-		UploadUniformInt(name, value);
-	}
+			std::string result(name.data());
+			if (result.ends_with("[0]"))
+			{
+				result.resize(result.size() - 3);
+			}
+			return result;
+		};
 
-	void OpenGLShader::UploadUniform(const std::string& name, const std::vector<int>& value)
-	{
-		SS_PROFILE_FUNCTION();
+		GLint uniformCount = 0;
+		glGetProgramInterfaceiv(m_RendererID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			constexpr GLenum properties[] = {GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE, GL_BLOCK_INDEX};
+			GLint values[std::size(properties)];
+			glGetProgramResourceiv(m_RendererID, GL_UNIFORM, i, std::size(properties), properties, std::size(values),
+			                       nullptr, values);
 
-		UploadUniformIntArray(name, value.data(), value.size());
-	}
+			if (values[4] != -1)
+			{
+				continue; // Member of a uniform block
+			}
 
-	void OpenGLShader::UploadUniform(const std::string& name, const float value)
-	{
-		SS_PROFILE_FUNCTION();
+			ShaderReflection::Uniform& uniform = reflection.Uniforms.emplace_back();
+			uniform.Name = getName(GL_UNIFORM, i, values[0]);
+			uniform.Type = ShaderDataTypeFromOpenGLType(static_cast<GLenum>(values[1]));
+			uniform.Location = values[2];
+			uniform.ArraySize = static_cast<uint32_t>(values[3]);
+			uniform.Sampler = IsOpenGLSamplerType(static_cast<GLenum>(values[1]));
+		}
 
-		UploadUniformFloat(name, value);
-	}
+		for (const auto [programInterface, blocks] : {
+			     std::pair{GL_UNIFORM_BLOCK, &reflection.UniformBlocks},
+			     std::pair{GL_SHADER_STORAGE_BLOCK, &reflection.StorageBlocks}
+		     })
+		{
+			GLint blockCount = 0;
+			glGetProgramInterfaceiv(m_RendererID, programInterface, GL_ACTIVE_RESOURCES, &blockCount);
+			for (GLint i = 0; i < blockCount; i++)
+			{
+				constexpr GLenum properties[] = {GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+				GLint values[std::size(properties)];
+				glGetProgramResourceiv(m_RendererID, programInterface, i, std::size(properties), properties, std::size(values),
+				                       nullptr, values);
 
-	void OpenGLShader::UploadUniform(const std::string& name, const glm::vec2& value)
-	{
-		SS_PROFILE_FUNCTION();
+				blocks->push_back({getName(programInterface, i, values[0]), static_cast<uint32_t>(values[1]),
+				                   static_cast<uint32_t>(values[2])});
+			}
+		}
 
-		UploadUniformFloat2(name, value);
-	}
+		GLint attributeCount = 0;
+		glGetProgramInterfaceiv(m_RendererID, GL_PROGRAM_INPUT, GL_ACTIVE_RESOURCES, &attributeCount);
+		for (GLint i = 0; i < attributeCount; i++)
+		{
+			constexpr GLenum properties[] = {GL_NAME_LENGTH, GL_TYPE, GL_LOCATION};
+			GLint values[std::size(properties)];
+			glGetProgramResourceiv(m_RendererID, GL_PROGRAM_INPUT, i, std::size(properties), properties,
+			                       std::size(values), nullptr, values);
 
-	void OpenGLShader::UploadUniform(const std::string& name, const glm::vec3& value)
-	{
-		SS_PROFILE_FUNCTION();
+			if (values[2] == -1)
+			{
+				continue; // Built-ins like gl_VertexID
+			}
 
-		UploadUniformFloat3(name, value);
+			reflection.Attributes.push_back({getName(GL_PROGRAM_INPUT, i, values[0]),
+			                                 ShaderDataTypeFromOpenGLType(static_cast<GLenum>(values[1])), values[2]});
+		}
+
+		SetReflection(std::move(reflection));
 	}
 
-	void OpenGLShader::UploadUniform(const std::string& name, const glm::vec4& value)
+
+	void OpenGLShader::Bind() const
 	{
 		SS_PROFILE_FUNCTION();
 
-		UploadUniformFloat4(name, value);
+		glUseProgram(m_RendererID);
 	}
 
-	void OpenGLShader::UploadUniform(const std::string& name, const glm::mat4& value)
+	void OpenGLShader::Unbind() const
 	{
 		SS_PROFILE_FUNCTION();
 
-		UploadUniformMat4(name, value);
-	}
-
-	void OpenGLShader::UploadUniformInt(const std::string& name, const int value) const
-	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1i(location, value);
+		// Used for debugging purposes, do not need to unbind before binding another shader
+		glUseProgram(0);
 	}
 
-	void OpenGLShader::UploadUniformIntArray(const std::string& name, const int* values, const uint32_t count) const
+	// Uniforms are written through the program directly, so the shader doesn't have to be bound
+	void OpenGLShader::UploadUniform(const UniformSlot& uniform, const int value)
 	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1iv(location, count, values);
+		glProgramUniform1i(m_RendererID, uniform.Location, value);
 	}
 
-	void OpenGLShader::UploadUniformFloat(const std::string& name, const float value) const
+	void OpenGLShader::UploadUniform(const UniformSlot& uniform, const std::vector<int>& values)
 	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1f(location, value);
+		glProgramUniform1iv(m_RendererID, uniform.Location, static_cast<GLsizei>(values.size()), values.data());
 	}
 
-	void OpenGLShader::UploadUniformFloat2(const std::string& name, const glm::vec2& values) const
+	void OpenGLShader::UploadUniform(const UniformSlot& uniform, const float value)
 	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform2f(location, values.x, values.y);
+		glProgramUniform1f(m_RendererID, uniform.Location, value);
 	}
 
-	void OpenGLShader::UploadUniformFloat3(const std::string& name, const glm::vec3& values) const
+	void OpenGLShader::UploadUniform(const UniformSlot& uniform, const glm::vec2& value)
 	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform3f(location, values.x, values.y, values.z);
+		glProgramUniform2f(m_RendererID, uniform.Location, value.x, value.y);
 	}
 
-
-	void OpenGLShader::UploadUniformFloat4(const std::string& name, const glm::vec4& values) const
+	void OpenGLShader::UploadUniform(const UniformSlot& uniform, const glm::vec3& value)
 	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform4f(location, values.x, values.y, values.z, values.w);
+		glProgramUniform3f(m_RendererID, uniform.Location, value.x, value.y, value.z);
 	}
 
-	void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& matrix) const
+	void OpenGLShader::UploadUniform(const UniformSlot& uniform, const glm::vec4& value)
 	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniformMatrix3fv(location, 1, GL_FALSE, value_ptr(matrix));
+		glProgramUniform4f(m_RendererID, uniform.Location, value.x, value.y, value.z, value.w);
 	}
 
-	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix) const
+	void OpenGLShader::UploadUniform(const UniformSlot& uniform, const glm::mat4& value)
 	{
-		const GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniformMatrix4fv(location, 1, GL_FALSE, value_ptr(matrix));
+		glProgramUniformMatrix4fv(m_RendererID, uniform.Location, 1, GL_FALSE, value_ptr(value));
 	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 #include <glm/glm.hpp>
 
 #include "Snowstorm/Render/Shader.hpp"
@@ -24,35 +26,46 @@ namespace Snowstorm
 		void Bind() const override;
 		void Unbind() const override;
 
-		void UploadUniform(const std::string& name, int value) override;
-		void UploadUniform(const std::string& name, const std::vector<int>& value) override;
-		void UploadUniform(const std::string& name, float value) override;
-		void UploadUniform(const std::string& name, const glm::vec2& value) override;
-		void UploadUniform(const std::string& name, const glm::vec3& value) override;
-		void UploadUniform(const std::string& name, const glm::vec4& value) override;
-		void UploadUniform(const std::string& name, const glm::mat4& value) override;
-
 		[[nodiscard]] const std::string& GetPath() const override { return m_Filepath; }
 
-		void UploadUniformInt(const std::string& name, int value) const;
-		void UploadUniformIntArray(const std::string& name, const int* values, uint32_t count) const;
+		[[nodiscard]] std::optional<ShaderCompileResult> PollRecompile() override;
 
-		void UploadUniformFloat(const std::string& name, float value) const;
-		void UploadUniformFloat2(const std::string& name, const glm::vec2& values) const;
-		void UploadUniformFloat3(const std::string& name, const glm::vec3& values) const;
-		void UploadUniformFloat4(const std::string& name, const glm::vec4& values) const;
-
-		void UploadUniformMat3(const std::string& name, const glm::mat3& matrix) const;
-		void UploadUniformMat4(const std::string& name, const glm::mat4& matrix) const;
+	protected:
+		void UploadUniform(const UniformSlot& uniform, int value) override;
+		void UploadUniform(const UniformSlot& uniform, const std::vector<int>& values) override;
+		void UploadUniform(const UniformSlot& uniform, float value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::vec2& value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::vec3& value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::vec4& value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::mat4& value) override;
 
 	private:
 		static std::string ReadFile(const std::string& filepath);
 		static std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
 
+		// A program whose stages are compiling and linking, possibly on driver threads
+		struct PendingProgram
+		{
+			uint32_t Program = 0;
+			std::vector<uint32_t> Shaders; // Empty when the program was loaded from the program cache
+			uint64_t CacheKey = 0;
+			bool Cached = false;
+		};
+
 		void Compile() override;
-		void Compile(std::unordered_map<GLenum, std::string>& shaderSources);
+		void CompileNow(const std::unordered_map<GLenum, std::string>& shaderSources);
 
-		uint32_t m_RendererID;
+		static PendingProgram BeginCompile(const std::unordered_map<GLenum, std::string>& shaderSources);
+		static bool IsCompileComplete(const PendingProgram& pending);
+		// Makes the program current if it linked, releases it otherwise
+		ShaderCompileResult FinishCompile(const PendingProgram& pending);
+		static void DiscardProgram(const PendingProgram& pending);
+
+		void Reflect();
+
+		uint32_t m_RendererID = 0;
 		std::string m_Filepath;
+
+		std::optional<PendingProgram> m_PendingProgram; // Recompile waiting for PollRecompile
 	};
 }
@@ -0,0 +1,40 @@
+#include "pch.h"
+
+#include "OpenGLStorageBuffer.hpp"
+
+#include <GL/glew.h>
+
+namespace Snowstorm
+{
+	OpenGLStorageBuffer::OpenGLStorageBuffer(const uint32_t size, const uint32_t binding)
+		: m_Size(size), m_Binding(binding)
+	{
+		glGenBuffers(1, &m_RendererID);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_RendererID);
+	}
+
+	OpenGLStorageBuffer::~OpenGLStorageBuffer()
+	{
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLStorageBuffer::SetData(const void* data, const uint32_t size, const uint32_t offset)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+
+		if (offset + size > m_Size)
+		{
+			m_Size = std::max(offset + size, m_Size * 2);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW);
+		}
+
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+	}
+
+	void OpenGLStorageBuffer::Bind() const
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_RendererID);
+	}
+}
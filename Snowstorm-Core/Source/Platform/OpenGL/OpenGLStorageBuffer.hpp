@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Snowstorm/Render/StorageBuffer.hpp"
+
+namespace Snowstorm
+{
+	class OpenGLStorageBuffer final : public StorageBuffer
+	{
+	public:
+		OpenGLStorageBuffer(uint32_t size, uint32_t binding);
+		~OpenGLStorageBuffer() override;
+
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+		void Bind() const override;
+
+		[[nodiscard]] uint32_t GetRendererID() const override { return m_RendererID; }
+
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Size;
+		uint32_t m_Binding;
+	};
+}
@@ -9,6 +9,29 @@
 
 namespace Snowstorm
 {
+	namespace
+	{
+		// Whether any pixel of data in the given format is less than fully opaque
+		bool HasTranslucentTexels(const uint8_t* data, const uint32_t width, const uint32_t height, const GLenum format)
+		{
+			if (format != GL_RGBA)
+			{
+				return false;
+			}
+
+			const size_t texelCount = static_cast<size_t>(width) * height;
+			for (size_t i = 0; i < texelCount; i++)
+			{
+				if (data[i * 4 + 3] != 255)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	}
+
 	OpenGLTexture2D::OpenGLTexture2D(const uint32_t width, const uint32_t height)
 		: m_Width(width), m_Height(height)
 	{
@@ -70,6 +93,7 @@ namespace Snowstorm
 		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
 		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, dataFormat, GL_UNSIGNED_BYTE, data);
+		m_HasTranslucentTexels = HasTranslucentTexels(data, m_Width, m_Height, dataFormat);
 
 		stbi_image_free(data);
 	}
@@ -78,6 +102,11 @@ namespace Snowstorm
 	{
 		SS_PROFILE_FUNCTION();
 
+		if (m_BindlessHandle)
+		{
+			glMakeTextureHandleNonResidentARB(m_BindlessHandle);
+		}
+
 		glDeleteTextures(1, &m_RendererID);
 	}
 
@@ -88,6 +117,47 @@ namespace Snowstorm
 		const uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
 		SS_CORE_ASSERT(size == m_Width * m_Height * bpp, "Data must be entire texture!");
 		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+		const auto* pixels = static_cast<const uint8_t*>(data);
+		m_HasTranslucentTexels = HasTranslucentTexels(pixels, m_Width, m_Height, m_DataFormat);
+	}
+
+	bool OpenGLTexture2D::Reload()
+	{
+		SS_PROFILE_FUNCTION();
+
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load(1);
+		stbi_uc* data = stbi_load(m_Path.c_str(), &width, &height, &channels, 0);
+		if (!data)
+		{
+			SS_CORE_WARN("Could not reload texture '{0}': {1}", m_Path, stbi_failure_reason());
+			return false;
+		}
+
+		// The storage is immutable and may be referenced through a bindless handle, so only its contents can change
+		const GLenum dataFormat = channels == 4 ? GL_RGBA : channels == 3 ? GL_RGB : 0;
+		const bool matches = static_cast<uint32_t>(width) == m_Width && static_cast<uint32_t>(height) == m_Height &&
+			dataFormat == m_DataFormat;
+		if (matches)
+		{
+			glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+			m_HasTranslucentTexels = HasTranslucentTexels(data, m_Width, m_Height, m_DataFormat);
+		}
+		else
+		{
+			SS_CORE_WARN("Could not reload texture '{0}', its size or channel count changed", m_Path);
+		}
+
+		stbi_image_free(data);
+		return matches;
+	}
+
+	void OpenGLTexture2D::SetDistanceField(const bool distanceField)
+	{
+		Texture2D::SetDistanceField(distanceField);
+
+		// Distance fields have to be interpolated to stay sharp when magnified
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, distanceField ? GL_LINEAR : GL_NEAREST);
 	}
 
 	void OpenGLTexture2D::Bind(const uint32_t slot) const
@@ -96,4 +166,15 @@ namespace Snowstorm
 
 		glBindTextureUnit(slot, m_RendererID);
 	}
+
+	uint64_t OpenGLTexture2D::GetBindlessHandle() const
+	{
+		if (!m_BindlessHandle && GLEW_ARB_bindless_texture)
+		{
+			m_BindlessHandle = glGetTextureHandleARB(m_RendererID);
+			glMakeTextureHandleResidentARB(m_BindlessHandle);
+		}
+
+		return m_BindlessHandle;
+	}
 }
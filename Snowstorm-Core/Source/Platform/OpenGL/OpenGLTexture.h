@@ -23,10 +23,20 @@ namespace Snowstorm
 
 		uint32_t GetRendererID() const override { return m_RendererID; }
 
+		const std::string& GetPath() const override { return m_Path; }
+
+		bool HasAlphaChannel() const override { return m_HasTranslucentTexels; }
+
 		void SetData(void* data, uint32_t size) override;
 
+		bool Reload() override;
+
 		void Bind(uint32_t slot = 0) const override;
 
+		uint64_t GetBindlessHandle() const override;
+
+		void SetDistanceField(bool distanceField) override;
+
 		bool operator==(const Texture& other) const override
 		{
 			return m_RendererID == dynamic_cast<const OpenGLTexture2D&>(other).m_RendererID;
@@ -37,5 +47,8 @@ namespace Snowstorm
 		uint32_t m_Width, m_Height;
 		uint32_t m_RendererID;
 		GLenum m_InternalFormat, m_DataFormat;
+		bool m_HasTranslucentTexels = true; // Found by scanning whatever was uploaded last, see SetData and Reload
+
+		mutable GLuint64 m_BindlessHandle = 0; // Created and made resident on first request
 	};
 }
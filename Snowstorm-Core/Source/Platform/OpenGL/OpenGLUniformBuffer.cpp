@@ -24,4 +24,9 @@ namespace Snowstorm
 		glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
 		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
 	}
+
+	void OpenGLUniformBuffer::BindRange(const uint32_t binding, const uint32_t offset, const uint32_t size) const
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_RendererID, offset, size);
+	}
 }
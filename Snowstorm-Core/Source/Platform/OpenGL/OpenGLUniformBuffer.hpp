@@ -11,6 +11,7 @@ namespace Snowstorm
 		~OpenGLUniformBuffer() override;
 
 		void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+		void BindRange(uint32_t binding, uint32_t offset, uint32_t size) const override;
 		[[nodiscard]] uint32_t GetRendererID() const override { return m_RendererID; }
 
 	private:
@@ -21,6 +21,7 @@ namespace Snowstorm
 			case ShaderDataType::Int2:
 			case ShaderDataType::Int3:
 			case ShaderDataType::Int4: return GL_INT;
+			case ShaderDataType::Byte4: return GL_UNSIGNED_BYTE;
 			case ShaderDataType::Bool: return GL_BOOL;
 			case ShaderDataType::None: break;
 			}
@@ -50,8 +50,21 @@ namespace Snowstorm
 		// TODO this should not actually exist - move it to swap buffers in OpenGl
 	}
 
-	void VulkanRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, const uint32_t indexCount)
+	void VulkanRendererAPI::SetDepthFunction(const DepthFunction function)
 	{
+		// TODO depth state is baked into the graphics pipeline on Vulkan
+	}
+
+	void VulkanRendererAPI::SetWriteMask(const bool color, const bool depth)
+	{
+		// TODO write masks are baked into the graphics pipeline on Vulkan
+	}
+
+	void VulkanRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, const uint32_t indexCount,
+	                                    const uint32_t baseVertex)
+	{
+		SS_CORE_ASSERT(baseVertex == 0, "Base vertex offsets are currently not supported on Vulkan!");
+
 		const VulkanDrawCallCommand drawCallCommand{
 			vertexArray,
 			indexCount,
@@ -61,7 +74,15 @@ namespace Snowstorm
 		VulkanSwapChainQueue::GetInstance()->AddDrawCall(drawCallCommand);
 	}
 
-	void VulkanRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, const uint32_t indexCount, const uint32_t instanceCount)
+	void VulkanRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, const uint32_t indexCount,
+	                                             const uint32_t instanceCount, const uint32_t baseInstance,
+	                                             const uint32_t baseVertex)
+	{
+	}
+
+	void VulkanRendererAPI::DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands,
+	                                            const uint32_t drawCount, const uint32_t offset)
 	{
+		SS_CORE_ASSERT(false, "Indirect draws are currently not supported on Vulkan!");
 	}
 }
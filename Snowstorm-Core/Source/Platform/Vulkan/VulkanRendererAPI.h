@@ -16,8 +16,14 @@ namespace Snowstorm
 		void SetClearColor(const glm::vec4& color) override;
 		void Clear() override;
 
-		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount) override;
-		void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount) override;
+		void SetDepthFunction(DepthFunction function) override;
+		void SetWriteMask(bool color, bool depth) override;
+
+		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t baseVertex) override;
+		void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount,
+		                          uint32_t baseInstance, uint32_t baseVertex) override;
+		void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands,
+		                         uint32_t drawCount, uint32_t offset) override;
 
 	private:
 		Scope<VulkanCommandBuffers> m_VulkanCommandBuffer;
@@ -58,37 +58,37 @@ namespace Snowstorm
 	{
 	}
 
-	void VulkanShader::UploadUniform(const std::string& name, const int value)
+	void VulkanShader::UploadUniform(const UniformSlot& uniform, const int value)
 	{
-		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(name, &value, sizeof(int));
+		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(uniform.Name, &value, sizeof(int));
 	}
 
-	void VulkanShader::UploadUniform(const std::string& name, const std::vector<int>& value)
+	void VulkanShader::UploadUniform(const UniformSlot& uniform, const std::vector<int>& value)
 	{
-		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(name, value.data(), value.size() * sizeof(int));
+		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(uniform.Name, value.data(), value.size() * sizeof(int));
 	}
 
-	void VulkanShader::UploadUniform(const std::string& name, const float value)
+	void VulkanShader::UploadUniform(const UniformSlot& uniform, const float value)
 	{
-		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(name, &value, sizeof(float));
+		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(uniform.Name, &value, sizeof(float));
 	}
 
-	void VulkanShader::UploadUniform(const std::string& name, const glm::vec2& value)
+	void VulkanShader::UploadUniform(const UniformSlot& uniform, const glm::vec2& value)
 	{
-		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(name, &value, sizeof(glm::vec2));
+		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(uniform.Name, &value, sizeof(glm::vec2));
 	}
 
-	void VulkanShader::UploadUniform(const std::string& name, const glm::vec3& value)
+	void VulkanShader::UploadUniform(const UniformSlot& uniform, const glm::vec3& value)
 	{
-		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(name, &value, sizeof(glm::vec3));
+		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(uniform.Name, &value, sizeof(glm::vec3));
 	}
 
-	void VulkanShader::UploadUniform(const std::string& name, const glm::vec4& value)
+	void VulkanShader::UploadUniform(const UniformSlot& uniform, const glm::vec4& value)
 	{
-		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(name, &value, sizeof(glm::vec4));
+		VulkanSwapChainQueue::GetInstance()->EnqueueUniformBufferValue(uniform.Name, &value, sizeof(glm::vec4));
 	}
 
-	void VulkanShader::UploadUniform(const std::string& name, const glm::mat4& value)
+	void VulkanShader::UploadUniform(const UniformSlot& uniform, const glm::mat4& value)
 	{
 		VulkanContext::UpdateViewProjection(value);
 	}
@@ -18,17 +18,18 @@ namespace Snowstorm
 		void Bind() const override;
 		void Unbind() const override;
 
-		void UploadUniform(const std::string& name, int value) override;
-		void UploadUniform(const std::string& name, const std::vector<int>& value) override;
-		void UploadUniform(const std::string& name, float value) override;
-		void UploadUniform(const std::string& name, const glm::vec2& value) override;
-		void UploadUniform(const std::string& name, const glm::vec3& value) override;
-		void UploadUniform(const std::string& name, const glm::vec4& value) override;
-		void UploadUniform(const std::string& name, const glm::mat4& value) override;
+		void UploadUniform(const UniformSlot& uniform, int value) override;
+		void UploadUniform(const UniformSlot& uniform, const std::vector<int>& value) override;
+		void UploadUniform(const UniformSlot& uniform, float value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::vec2& value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::vec3& value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::vec4& value) override;
+		void UploadUniform(const UniformSlot& uniform, const glm::mat4& value) override;
 
 		const std::string& GetPath() const override { return m_Filepath; }
 
 		void Compile() override;
+		std::optional<ShaderCompileResult> PollRecompile() override { return std::nullopt; }
 
 	private:
 		VkDevice m_Device;
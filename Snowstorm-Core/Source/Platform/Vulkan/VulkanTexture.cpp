@@ -9,6 +9,7 @@ namespace Snowstorm
 	}
 
 	VulkanTexture2D::VulkanTexture2D(std::string path)
+		: m_Path(std::move(path))
 	{
 	}
 
@@ -32,6 +33,11 @@ namespace Snowstorm
 		return 0;
 	}
 
+	bool VulkanTexture2D::HasAlphaChannel() const
+	{
+		return true;
+	}
+
 	void VulkanTexture2D::SetData(void* data, uint32_t size)
 	{
 	}
@@ -15,9 +15,16 @@ namespace Snowstorm
 
 		uint32_t GetRendererID() const override;
 
+		const std::string& GetPath() const override { return m_Path; }
+
+		bool HasAlphaChannel() const override;
+
 		void SetData(void* data, uint32_t size) override;
 		void Bind(uint32_t slot) const override;
 
 		bool operator==(const Texture& other) const override;
+
+	private:
+		std::string m_Path;
 	};
 }
@@ -22,6 +22,7 @@ namespace Snowstorm
 			case ShaderDataType::Int2: return VK_FORMAT_R32G32_SINT;
 			case ShaderDataType::Int3: return VK_FORMAT_R32G32B32_SINT;
 			case ShaderDataType::Int4: return VK_FORMAT_R32G32B32A32_SINT;
+			case ShaderDataType::Byte4: return VK_FORMAT_R8G8B8A8_UNORM;
 			case ShaderDataType::Bool: return VK_FORMAT_R8_UINT;
 			case ShaderDataType::None: break;
 			}
@@ -20,6 +20,7 @@
 
 // ---Renderer------------------------
 #include "Snowstorm/Render/Renderer2D.hpp"
+#include "Snowstorm/Render/Renderer2DSingleton.hpp"
 #include "Snowstorm/Render/RenderCommand.hpp"
 
 #include "Snowstorm/Render/Buffer.hpp"
@@ -5,8 +5,11 @@
 
 #include <ranges>
 
+#include "Snowstorm/Core/JobSystem.hpp"
 #include "Snowstorm/Render/RenderCommand.hpp"
 #include "Snowstorm/Render/Renderer2D.hpp"
+#include "Snowstorm/Render/TilemapRenderer.hpp"
+#include "Snowstorm/Service/FileWatcherService.hpp"
 #include "Snowstorm/Service/ImGuiService.hpp"
 
 namespace Snowstorm
@@ -28,17 +31,22 @@ namespace Snowstorm
 		// TODO think about this
 		m_ServiceManager = CreateScope<ServiceManager>();
 		m_ServiceManager->RegisterService<ImGuiService>();
+		m_ServiceManager->RegisterService<FileWatcherService>("assets");
 
 		// TODO these should be services (which have callable methods -> sort of like singletons, you can globally fetch a service through instance())
+		JobSystem::Init();
+		RenderCommand::Init(); // Fills in the capabilities the renderers depend on
 		Renderer2D::Init();
-		RenderCommand::Init();
+		TilemapRenderer::Init();
 	}
 
 	Application::~Application()
 	{
 		SS_PROFILE_FUNCTION();
 
+		TilemapRenderer::Shutdown();
 		Renderer2D::Shutdown();
+		JobSystem::Shutdown();
 	}
 
 	void Application::Run()
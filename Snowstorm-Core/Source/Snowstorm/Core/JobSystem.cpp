@@ -0,0 +1,157 @@
+#include "pch.h"
+#include "JobSystem.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Snowstorm
+{
+	namespace
+	{
+		struct JobSystemData
+		{
+			std::vector<std::thread> Workers;
+
+			std::deque<std::function<void()>> Queue;
+			std::mutex QueueMutex;
+			std::condition_variable QueueCondition;
+
+			bool Running = false;
+		};
+
+		JobSystemData s_Data;
+
+		bool TryRunPendingJob()
+		{
+			std::function<void()> job;
+			{
+				std::lock_guard lock(s_Data.QueueMutex);
+				if (s_Data.Queue.empty())
+				{
+					return false;
+				}
+
+				job = std::move(s_Data.Queue.front());
+				s_Data.Queue.pop_front();
+			}
+
+			job();
+			return true;
+		}
+
+		void WorkerLoop()
+		{
+			while (true)
+			{
+				std::function<void()> job;
+				{
+					std::unique_lock lock(s_Data.QueueMutex);
+					s_Data.QueueCondition.wait(lock, [] { return !s_Data.Queue.empty() || !s_Data.Running; });
+
+					if (s_Data.Queue.empty())
+					{
+						return; // Shutting down
+					}
+
+					job = std::move(s_Data.Queue.front());
+					s_Data.Queue.pop_front();
+				}
+
+				job();
+			}
+		}
+	}
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		SS_PROFILE_FUNCTION();
+
+		SS_CORE_ASSERT(!s_Data.Running, "JobSystem already initialized!");
+
+		if (workerCount == 0)
+		{
+			const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		s_Data.Running = true;
+		s_Data.Workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			s_Data.Workers.emplace_back(WorkerLoop);
+		}
+	}
+
+	void JobSystem::Shutdown()
+	{
+		SS_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard lock(s_Data.QueueMutex);
+			s_Data.Running = false;
+		}
+		s_Data.QueueCondition.notify_all();
+
+		for (auto& worker : s_Data.Workers)
+		{
+			worker.join();
+		}
+		s_Data.Workers.clear();
+	}
+
+	void JobSystem::ParallelFor(const uint32_t count, uint32_t chunkSize, const RangeJob& job)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		chunkSize = std::max(chunkSize, 1u);
+		const uint32_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+		if (chunkCount == 1 || s_Data.Workers.empty())
+		{
+			job(0, count);
+			return;
+		}
+
+		std::atomic<uint32_t> remaining = chunkCount;
+
+		{
+			std::lock_guard lock(s_Data.QueueMutex);
+			for (uint32_t chunk = 1; chunk < chunkCount; chunk++)
+			{
+				const uint32_t begin = chunk * chunkSize;
+				const uint32_t end = std::min(begin + chunkSize, count);
+
+				s_Data.Queue.emplace_back([&job, &remaining, begin, end]
+				{
+					job(begin, end);
+					remaining.fetch_sub(1, std::memory_order_release);
+				});
+			}
+		}
+		s_Data.QueueCondition.notify_all();
+
+		// The first chunk always runs on the calling thread
+		job(0, std::min(chunkSize, count));
+		remaining.fetch_sub(1, std::memory_order_release);
+
+		// Help out with queued work (possibly from other callers) instead of idling
+		while (remaining.load(std::memory_order_acquire) > 0)
+		{
+			if (!TryRunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return static_cast<uint32_t>(s_Data.Workers.size());
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Snowstorm
+{
+	// Fixed pool of worker threads used to split CPU-side frame work into chunks
+	class JobSystem
+	{
+	public:
+		using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+		// A worker count of 0 uses one worker per hardware thread, minus the calling thread
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		// Splits [0, count) into chunks of chunkSize and runs them on the workers, the calling thread helps out.
+		// Blocks until every chunk has finished, and can be called from inside another job.
+		static void ParallelFor(uint32_t count, uint32_t chunkSize, const RangeJob& job);
+
+		[[nodiscard]] static uint32_t GetWorkerCount();
+	};
+}
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <windows.h>
@@ -44,6 +45,9 @@ namespace Snowstorm
 
 		void WriteProfile(const ProfileResult& result)
 		{
+			// Profiled scopes can end on worker threads
+			std::lock_guard lock(m_Mutex);
+
 			if (m_ProfileCount++ > 0)
 				m_OutputStream << ",";
 
@@ -83,6 +87,7 @@ namespace Snowstorm
 	private:
 		InstrumentationSession* m_CurrentSession;
 		std::ofstream m_OutputStream;
+		std::mutex m_Mutex;
 		int m_ProfileCount;
 	};
 
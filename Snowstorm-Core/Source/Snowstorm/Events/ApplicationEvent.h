@@ -63,4 +63,62 @@ namespace Snowstorm
 		EVENT_CLASS_TYPE(AppRender)
 		EVENT_CLASS_CATEGORY(EventCategoryApplication)
 	};
+
+	// The file at Path was written, see FileWatcherService
+	struct FileChangedEvent final : Event
+	{
+		explicit FileChangedEvent(std::string path)
+			: Path(std::move(path))
+		{
+		}
+
+		[[nodiscard]] std::string ToString() const override
+		{
+			return "FileChangedEvent: " + Path;
+		}
+
+		EVENT_CLASS_TYPE(FileChanged)
+		EVENT_CLASS_CATEGORY(EventCategoryApplication)
+
+		std::string Path;
+	};
+
+	// A recompile of the shader at Filepath linked, the new program is in use
+	struct ShaderReloadedEvent final : Event
+	{
+		explicit ShaderReloadedEvent(std::string filepath)
+			: Filepath(std::move(filepath))
+		{
+		}
+
+		[[nodiscard]] std::string ToString() const override
+		{
+			return "ShaderReloadedEvent: " + Filepath;
+		}
+
+		EVENT_CLASS_TYPE(ShaderReloaded)
+		EVENT_CLASS_CATEGORY(EventCategoryApplication)
+
+		std::string Filepath;
+	};
+
+	// A recompile of the shader at Filepath failed, the previous program is still in use
+	struct ShaderCompileFailedEvent final : Event
+	{
+		ShaderCompileFailedEvent(std::string filepath, std::string log)
+			: Filepath(std::move(filepath)), Log(std::move(log))
+		{
+		}
+
+		[[nodiscard]] std::string ToString() const override
+		{
+			return "ShaderCompileFailedEvent: " + Filepath + "\n" + Log;
+		}
+
+		EVENT_CLASS_TYPE(ShaderCompileFailed)
+		EVENT_CLASS_CATEGORY(EventCategoryApplication)
+
+		std::string Filepath;
+		std::string Log;
+	};
 }
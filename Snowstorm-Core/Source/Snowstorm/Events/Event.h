@@ -27,7 +27,10 @@ namespace Snowstorm
 		MouseButtonPressed,
 		MouseButtonReleased,
 		MouseMoved,
-		MouseScrolled
+		MouseScrolled,
+		ShaderReloaded,
+		ShaderCompileFailed,
+		FileChanged
 	};
 
 	enum EventCategory : uint8_t
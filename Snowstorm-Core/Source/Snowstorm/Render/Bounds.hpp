@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Snowstorm
+{
+	// Axis aligned bounding box
+	struct AABB
+	{
+		glm::vec3 Min{0.0f};
+		glm::vec3 Max{0.0f};
+
+		[[nodiscard]] glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		[[nodiscard]] glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+		// Smallest axis aligned box containing this box after transform
+		[[nodiscard]] AABB Transform(const glm::mat4& transform) const
+		{
+			const glm::vec3 center = transform * glm::vec4{GetCenter(), 1.0f};
+			const glm::vec3 extents = abs(glm::mat3{transform}) * GetExtents();
+
+			return {center - extents, center + extents};
+		}
+	};
+
+	// Boxes stored as separate center and extent arrays, so they can be tested against planes several at a time
+	class PackedBounds
+	{
+	public:
+		void Resize(const uint32_t count)
+		{
+			m_CenterX.resize(count);
+			m_CenterY.resize(count);
+			m_CenterZ.resize(count);
+			m_ExtentX.resize(count);
+			m_ExtentY.resize(count);
+			m_ExtentZ.resize(count);
+		}
+
+		void Set(const uint32_t index, const glm::vec3& center, const glm::vec3& extents)
+		{
+			m_CenterX[index] = center.x;
+			m_CenterY[index] = center.y;
+			m_CenterZ[index] = center.z;
+			m_ExtentX[index] = extents.x;
+			m_ExtentY[index] = extents.y;
+			m_ExtentZ[index] = extents.z;
+		}
+
+		void Set(const uint32_t index, const AABB& bounds)
+		{
+			Set(index, bounds.GetCenter(), bounds.GetExtents());
+		}
+
+		[[nodiscard]] AABB Get(const uint32_t index) const
+		{
+			const glm::vec3 center{m_CenterX[index], m_CenterY[index], m_CenterZ[index]};
+			const glm::vec3 extents{m_ExtentX[index], m_ExtentY[index], m_ExtentZ[index]};
+			return {center - extents, center + extents};
+		}
+
+		[[nodiscard]] uint32_t GetCount() const { return static_cast<uint32_t>(m_CenterX.size()); }
+
+	private:
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+		std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+
+		friend class Frustum;
+	};
+}
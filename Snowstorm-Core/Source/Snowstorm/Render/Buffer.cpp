@@ -47,6 +47,24 @@ namespace Snowstorm
 		return nullptr;
 	}
 
+	Ref<StreamingVertexBuffer> StreamingVertexBuffer::Create(const uint32_t regionSize)
+	{
+		switch (Renderer2D::GetAPI())
+		{
+		case RendererAPI::API::None:
+			SS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+			return nullptr;
+		case RendererAPI::API::OpenGL:
+			return CreateRef<OpenGLStreamingVertexBuffer>(regionSize);
+		case RendererAPI::API::Vulkan:
+			SS_CORE_ASSERT(false, "Streaming vertex buffers are currently not supported on Vulkan!");
+			return nullptr;
+		}
+
+		SS_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
 	uint64_t IndexBuffer::GetHandle() const
 	{
 		return 0;
@@ -17,6 +17,7 @@ namespace Snowstorm
 		Int2,
 		Int3,
 		Int4,
+		Byte4, // Four unsigned bytes, usually read as a normalized vec4 (packed colors)
 		Bool
 	};
 
@@ -34,6 +35,7 @@ namespace Snowstorm
 		case ShaderDataType::Int2: return 4 * 2;
 		case ShaderDataType::Int3: return 4 * 3;
 		case ShaderDataType::Int4: return 4 * 4;
+		case ShaderDataType::Byte4: return 4;
 		case ShaderDataType::Bool: return 1;
 		case ShaderDataType::None: break;
 		}
@@ -74,6 +76,7 @@ namespace Snowstorm
 			case ShaderDataType::Int2: return 2;
 			case ShaderDataType::Int3: return 3;
 			case ShaderDataType::Int4: return 4;
+			case ShaderDataType::Byte4: return 4;
 			case ShaderDataType::Bool: return 1;
 			case ShaderDataType::None: break;
 			}
@@ -151,6 +154,35 @@ namespace Snowstorm
 		static Ref<VertexBuffer> Create(const void* data, uint32_t size);
 	};
 
+	// Persistently mapped vertex buffer for data that is rewritten every frame
+	// The buffer is split into RegionCount regions: the CPU writes into one while the GPU may still be reading the
+	// others, and BeginFrame waits for the GPU to release a region before it gets reused. Writes go straight into
+	// GPU-visible memory, so there is no staging copy or driver-side upload.
+	class StreamingVertexBuffer : public VertexBuffer
+	{
+	public:
+		static constexpr uint32_t RegionCount = 3;
+
+		struct Allocation
+		{
+			void* Data = nullptr; // nullptr if the region is out of space
+			uint32_t Offset = 0; // In bytes from the start of the buffer
+		};
+
+		// Moves on to the next region, blocking until the GPU is done with it
+		virtual void BeginFrame() = 0;
+		// Fences the current region, call once all draws reading from it were submitted
+		virtual void EndFrame() = 0;
+
+		// Sub-allocates from the current region, the offset is a multiple of alignment
+		virtual Allocation Allocate(uint32_t size, uint32_t alignment) = 0;
+
+		virtual uint32_t GetRegionSize() const = 0;
+
+		// SetData and SetSubData write relative to the start of the current region
+		static Ref<StreamingVertexBuffer> Create(uint32_t regionSize);
+	};
+
 	// Currently Snowstorm only supports 32-bit index buffers
 	class IndexBuffer
 	{
@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include "Frustum.hpp"
+
 namespace Snowstorm
 {
 	class Camera
@@ -18,6 +20,12 @@ namespace Snowstorm
 
 		const glm::mat4& GetProjection() const { return m_Projection; }
 
+		// View volume of the camera placed at transform, in world space
+		[[nodiscard]] Frustum GetFrustum(const glm::mat4& transform) const
+		{
+			return Frustum(m_Projection * inverse(transform));
+		}
+
 	protected:
 		glm::mat4 m_Projection{1.0f};
 	};
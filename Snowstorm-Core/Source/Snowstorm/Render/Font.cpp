@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "Font.hpp"
+
+#include <fstream>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+namespace Snowstorm
+{
+	namespace
+	{
+		constexpr uint32_t FirstCodepoint = 32;
+		constexpr uint32_t LastCodepoint = 126;
+		constexpr uint32_t FallbackCodepoint = '?';
+
+		// Pixels of distance stored around every glyph, which bounds how far outlines or glows could reach
+		constexpr int DistanceFieldPadding = 6;
+		constexpr unsigned char OnEdgeValue = 128; // Read back as 0.5 by the shaders
+
+		constexpr uint32_t AtlasPageSize = 1024;
+		constexpr uint32_t AtlasPadding = 1;
+
+		uint64_t GetKerningKey(const uint32_t first, const uint32_t second)
+		{
+			return static_cast<uint64_t>(first) << 32 | second;
+		}
+	}
+
+	Font::Font(const std::string& path, const float pixelHeight)
+		: m_Path(path)
+	{
+		SS_PROFILE_FUNCTION();
+
+		std::vector<uint8_t> fontData;
+		if (std::ifstream in(path, std::ios::in | std::ios::binary); in)
+		{
+			fontData.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+
+		stbtt_fontinfo info;
+		if (fontData.empty() || !stbtt_InitFont(&info, fontData.data(), stbtt_GetFontOffsetForIndex(fontData.data(), 0)))
+		{
+			SS_CORE_ERROR("Could not load font '{0}'", path);
+			return;
+		}
+
+		const float scale = stbtt_ScaleForPixelHeight(&info, pixelHeight);
+		const float toFontUnits = scale / pixelHeight; // From font design units to font size units
+
+		int ascent, descent, lineGap;
+		stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+		m_Ascent = static_cast<float>(ascent) * toFontUnits;
+		m_LineHeight = static_cast<float>(ascent - descent + lineGap) * toFontUnits;
+
+		TextureAtlasBuilder builder;
+		std::vector<uint8_t> pixels;
+
+		m_Glyphs.resize(LastCodepoint - FirstCodepoint + 1);
+		for (uint32_t codepoint = FirstCodepoint; codepoint <= LastCodepoint; codepoint++)
+		{
+			Glyph& glyph = m_Glyphs[codepoint - FirstCodepoint];
+
+			int advance, leftSideBearing;
+			stbtt_GetCodepointHMetrics(&info, static_cast<int>(codepoint), &advance, &leftSideBearing);
+			glyph.Advance = static_cast<float>(advance) * toFontUnits;
+
+			int width, height, offsetX, offsetY;
+			unsigned char* distanceField = stbtt_GetCodepointSDF(&info, scale, static_cast<int>(codepoint),
+			                                                     DistanceFieldPadding, OnEdgeValue,
+			                                                     static_cast<float>(OnEdgeValue) / DistanceFieldPadding,
+			                                                     &width, &height, &offsetX, &offsetY);
+			if (!distanceField)
+			{
+				continue;
+			}
+
+			// stb_truetype offsets the top left corner with y pointing down
+			glyph.Offset = glm::vec2{static_cast<float>(offsetX), -static_cast<float>(offsetY + height)} / pixelHeight;
+			glyph.Size = glm::vec2{static_cast<float>(width), static_cast<float>(height)} / pixelHeight;
+
+			// White texels carrying the distance in alpha, flipped to bottom row first
+			pixels.resize(static_cast<size_t>(width) * height * 4);
+			for (int y = 0; y < height; y++)
+			{
+				const unsigned char* sourceRow = distanceField + static_cast<size_t>(height - 1 - y) * width;
+				uint8_t* row = &pixels[static_cast<size_t>(y) * width * 4];
+
+				for (int x = 0; x < width; x++)
+				{
+					row[x * 4 + 0] = 255;
+					row[x * 4 + 1] = 255;
+					row[x * 4 + 2] = 255;
+					row[x * 4 + 3] = sourceRow[x];
+				}
+			}
+
+			builder.AddImage(std::to_string(codepoint), pixels.data(), static_cast<uint32_t>(width),
+			                 static_cast<uint32_t>(height));
+			stbtt_FreeSDF(distanceField, nullptr);
+		}
+
+		if (!builder.Pack(AtlasPageSize, AtlasPadding))
+		{
+			SS_CORE_ERROR("Could not pack the glyphs of font '{0}'", path);
+			return;
+		}
+
+		m_Atlas = builder.CreateAtlas();
+		for (uint32_t page = 0; page < m_Atlas->GetPageCount(); page++)
+		{
+			m_Atlas->GetPage(page)->SetDistanceField(true);
+		}
+
+		for (uint32_t codepoint = FirstCodepoint; codepoint <= LastCodepoint; codepoint++)
+		{
+			Glyph& glyph = m_Glyphs[codepoint - FirstCodepoint];
+			if (const TextureAtlas::Region* region = m_Atlas->Find(std::to_string(codepoint)))
+			{
+				glyph.UVRect = region->UVRect;
+				glyph.Page = region->Page;
+			}
+
+			for (uint32_t next = FirstCodepoint; next <= LastCodepoint; next++)
+			{
+				if (const int kerning = stbtt_GetCodepointKernAdvance(&info, static_cast<int>(codepoint), static_cast<int>(next)))
+				{
+					m_Kerning[GetKerningKey(codepoint, next)] = static_cast<float>(kerning) * toFontUnits;
+				}
+			}
+		}
+	}
+
+	const Font::Glyph* Font::GetGlyph(uint32_t codepoint) const
+	{
+		if (m_Glyphs.empty())
+		{
+			return nullptr;
+		}
+
+		if (codepoint < FirstCodepoint || codepoint > LastCodepoint)
+		{
+			codepoint = FallbackCodepoint;
+		}
+
+		return &m_Glyphs[codepoint - FirstCodepoint];
+	}
+
+	float Font::GetKerning(const uint32_t first, const uint32_t second) const
+	{
+		const auto it = m_Kerning.find(GetKerningKey(first, second));
+		return it != m_Kerning.end() ? it->second : 0.0f;
+	}
+
+	bool TextLayout::Update(const std::string& text, const Ref<Font>& font)
+	{
+		if (font == m_Font && text == m_Text)
+		{
+			return false;
+		}
+
+		SS_PROFILE_FUNCTION();
+
+		m_Text = text;
+		m_Font = font;
+		m_Quads.clear();
+
+		if (!m_Font)
+		{
+			return true;
+		}
+
+		glm::vec2 pen{0.0f};
+		uint32_t previous = 0;
+
+		for (const char character : m_Text)
+		{
+			const auto codepoint = static_cast<uint32_t>(static_cast<unsigned char>(character));
+			if (codepoint == '\n')
+			{
+				pen = {0.0f, pen.y - m_Font->GetLineHeight()};
+				previous = 0;
+				continue;
+			}
+
+			const Font::Glyph* glyph = m_Font->GetGlyph(codepoint);
+			if (!glyph)
+			{
+				break;
+			}
+
+			if (previous)
+			{
+				pen.x += m_Font->GetKerning(previous, codepoint);
+			}
+
+			if (glyph->Size.x > 0.0f)
+			{
+				m_Quads.push_back({pen + glyph->Offset + glyph->Size * 0.5f, glyph->Size, glyph->UVRect, glyph->Page});
+			}
+
+			pen.x += glyph->Advance;
+			previous = codepoint;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "TextureAtlas.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// TrueType font baked into signed distance field glyphs
+	// Glyphs are packed into a TextureAtlas whose pages are flagged as distance fields, so Renderer2D draws them
+	// sharp at any scale. All metrics are in units of the font size: a line of text is about 1 unit tall.
+	class Font final : public NonCopyable
+	{
+	public:
+		struct Glyph
+		{
+			glm::vec2 Offset{0.0f}; // Bottom left corner of the quad, relative to the pen position on the baseline
+			glm::vec2 Size{0.0f}; // Zero for glyphs without an outline, like space
+			glm::vec4 UVRect{0.0f};
+			uint32_t Page = 0;
+			float Advance = 0.0f;
+		};
+
+		// Bakes the printable ASCII range, pixelHeight is the resolution of the distance fields
+		explicit Font(const std::string& path, float pixelHeight = 48.0f);
+
+		// Falls back to '?' for codepoints that weren't baked, nullptr if the font failed to load
+		[[nodiscard]] const Glyph* GetGlyph(uint32_t codepoint) const;
+		[[nodiscard]] float GetKerning(uint32_t first, uint32_t second) const;
+
+		[[nodiscard]] float GetLineHeight() const { return m_LineHeight; }
+		[[nodiscard]] float GetAscent() const { return m_Ascent; }
+
+		[[nodiscard]] const Ref<TextureAtlas>& GetAtlas() const { return m_Atlas; }
+		[[nodiscard]] const std::string& GetPath() const { return m_Path; }
+
+	private:
+		std::string m_Path;
+
+		std::vector<Glyph> m_Glyphs; // Indexed by codepoint - FirstCodepoint
+		std::unordered_map<uint64_t, float> m_Kerning; // Non-zero pairs only, keyed on (first << 32) | second
+		Ref<TextureAtlas> m_Atlas;
+
+		float m_LineHeight = 1.0f;
+		float m_Ascent = 1.0f;
+	};
+
+	// Glyph quads of a string in text space, shaped once and reused until the string or font changes
+	class TextLayout
+	{
+	public:
+		struct GlyphQuad
+		{
+			glm::vec2 Center;
+			glm::vec2 Size;
+			glm::vec4 UVRect;
+			uint32_t Page;
+		};
+
+		// Shapes the text if it differs from the last call, returns whether it did. Lines are split on '\n' and
+		// the first baseline sits at y = 0.
+		bool Update(const std::string& text, const Ref<Font>& font);
+
+		[[nodiscard]] const std::vector<GlyphQuad>& GetQuads() const { return m_Quads; }
+		[[nodiscard]] const Ref<Font>& GetFont() const { return m_Font; }
+
+		// Model matrix of a glyph quad for text placed at transform
+		[[nodiscard]] static glm::mat4 GetGlyphTransform(const glm::mat4& transform, const GlyphQuad& quad)
+		{
+			glm::mat4 result = transform;
+			result[3] = transform * glm::vec4{quad.Center, 0.0f, 1.0f};
+			result[0] *= quad.Size.x;
+			result[1] *= quad.Size.y;
+			return result;
+		}
+
+	private:
+		std::string m_Text;
+		Ref<Font> m_Font;
+		std::vector<GlyphQuad> m_Quads;
+	};
+}
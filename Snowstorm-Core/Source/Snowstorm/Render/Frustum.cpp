@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "Frustum.hpp"
+
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SS_FRUSTUM_SSE
+#include <emmintrin.h>
+#endif
+
+#include "Snowstorm/Core/JobSystem.hpp"
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Boxes tested per job
+		constexpr uint32_t BoundsPerJob = 4096;
+	}
+
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		// Gribb-Hartmann: every plane is the last row of the matrix plus or minus one of the others
+		const auto row = [&](const int i)
+		{
+			return glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+		};
+
+		m_Planes[0] = row(3) + row(0); // Left
+		m_Planes[1] = row(3) - row(0); // Right
+		m_Planes[2] = row(3) + row(1); // Bottom
+		m_Planes[3] = row(3) - row(1); // Top
+		m_Planes[4] = row(3) + row(2); // Near
+		m_Planes[5] = row(3) - row(2); // Far
+
+		for (glm::vec4& plane : m_Planes)
+		{
+			plane /= length(glm::vec3{plane});
+		}
+	}
+
+	bool Frustum::Intersects(const AABB& bounds) const
+	{
+		const glm::vec3 center = bounds.GetCenter();
+		const glm::vec3 extents = bounds.GetExtents();
+
+		for (const glm::vec4& plane : m_Planes)
+		{
+			// Distance of the box corner furthest along the plane normal
+			const glm::vec3 normal{plane};
+			if (dot(normal, center) + dot(abs(normal), extents) + plane.w < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Frustum::Cull(const PackedBounds& bounds, const uint32_t begin, const uint32_t end, uint8_t* visible) const
+	{
+		uint32_t i = begin;
+
+#ifdef SS_FRUSTUM_SSE
+		const __m128 zero = _mm_setzero_ps();
+
+		for (; i + 4 <= end; i += 4)
+		{
+			const __m128 centerX = _mm_loadu_ps(&bounds.m_CenterX[i]);
+			const __m128 centerY = _mm_loadu_ps(&bounds.m_CenterY[i]);
+			const __m128 centerZ = _mm_loadu_ps(&bounds.m_CenterZ[i]);
+			const __m128 extentX = _mm_loadu_ps(&bounds.m_ExtentX[i]);
+			const __m128 extentY = _mm_loadu_ps(&bounds.m_ExtentY[i]);
+			const __m128 extentZ = _mm_loadu_ps(&bounds.m_ExtentZ[i]);
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (const glm::vec4& plane : m_Planes)
+			{
+				__m128 distance = _mm_set1_ps(plane.w);
+				distance = _mm_add_ps(distance, _mm_mul_ps(centerX, _mm_set1_ps(plane.x)));
+				distance = _mm_add_ps(distance, _mm_mul_ps(centerY, _mm_set1_ps(plane.y)));
+				distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, _mm_set1_ps(plane.z)));
+				distance = _mm_add_ps(distance, _mm_mul_ps(extentX, _mm_set1_ps(std::abs(plane.x))));
+				distance = _mm_add_ps(distance, _mm_mul_ps(extentY, _mm_set1_ps(std::abs(plane.y))));
+				distance = _mm_add_ps(distance, _mm_mul_ps(extentZ, _mm_set1_ps(std::abs(plane.z))));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+			}
+
+			const int mask = _mm_movemask_ps(inside);
+			visible[i + 0] = static_cast<uint8_t>(mask & 1);
+			visible[i + 1] = static_cast<uint8_t>(mask >> 1 & 1);
+			visible[i + 2] = static_cast<uint8_t>(mask >> 2 & 1);
+			visible[i + 3] = static_cast<uint8_t>(mask >> 3 & 1);
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			const glm::vec3 center{bounds.m_CenterX[i], bounds.m_CenterY[i], bounds.m_CenterZ[i]};
+			const glm::vec3 extents{bounds.m_ExtentX[i], bounds.m_ExtentY[i], bounds.m_ExtentZ[i]};
+
+			visible[i] = Intersects({center - extents, center + extents}) ? 1 : 0;
+		}
+	}
+
+	uint32_t Frustum::Cull(const PackedBounds& bounds, std::vector<uint8_t>& visible) const
+	{
+		SS_PROFILE_FUNCTION();
+
+		const uint32_t count = bounds.GetCount();
+		visible.resize(count);
+
+		std::atomic<uint32_t> visibleCount = 0;
+		JobSystem::ParallelFor(count, BoundsPerJob, [&](const uint32_t begin, const uint32_t end)
+		{
+			Cull(bounds, begin, end, visible.data());
+
+			uint32_t jobVisibleCount = 0;
+			for (uint32_t i = begin; i < end; i++)
+			{
+				jobVisibleCount += visible[i];
+			}
+
+			visibleCount.fetch_add(jobVisibleCount, std::memory_order_relaxed);
+		});
+
+		return visibleCount.load(std::memory_order_relaxed);
+	}
+}
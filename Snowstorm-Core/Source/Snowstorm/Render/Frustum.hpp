@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Bounds.hpp"
+
+namespace Snowstorm
+{
+	// The six planes bounding a camera's view volume, normals pointing inwards
+	class Frustum
+	{
+	public:
+		Frustum() = default;
+
+		// Extracts the planes from a combined projection * view matrix
+		explicit Frustum(const glm::mat4& viewProjection);
+
+		[[nodiscard]] bool Intersects(const AABB& bounds) const;
+
+		// Sets visible[i] to 1 for every box in [begin, end) that intersects the frustum and to 0 for the rest.
+		// Tests four boxes per step with SSE where available.
+		void Cull(const PackedBounds& bounds, uint32_t begin, uint32_t end, uint8_t* visible) const;
+
+		// Culls all boxes on the job system, returns the number of visible ones
+		uint32_t Cull(const PackedBounds& bounds, std::vector<uint8_t>& visible) const;
+
+	private:
+		std::array<glm::vec4, 6> m_Planes{}; // xyz = normal, w = distance
+	};
+}
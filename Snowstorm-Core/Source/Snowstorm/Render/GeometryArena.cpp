@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "GeometryArena.hpp"
+
+#include "Material.hpp"
+
+namespace Snowstorm
+{
+	GeometryArena::GeometryArena(const uint32_t vertexCapacity, const uint32_t indexCapacity)
+		: m_VertexAllocator(vertexCapacity), m_IndexAllocator(indexCapacity)
+	{
+		CreateBuffers();
+	}
+
+	std::optional<GeometryAllocation> GeometryArena::Allocate(const uint32_t vertexCount, const uint32_t indexCount)
+	{
+		const auto baseVertex = m_VertexAllocator.Allocate(vertexCount);
+		if (!baseVertex)
+		{
+			return std::nullopt;
+		}
+
+		const auto firstIndex = m_IndexAllocator.Allocate(indexCount);
+		if (!firstIndex)
+		{
+			m_VertexAllocator.Free(*baseVertex, vertexCount);
+			return std::nullopt;
+		}
+
+		return GeometryAllocation{*baseVertex, vertexCount, *firstIndex, indexCount};
+	}
+
+	void GeometryArena::Free(const GeometryAllocation& allocation)
+	{
+		m_VertexAllocator.Free(allocation.BaseVertex, allocation.VertexCount);
+		m_IndexAllocator.Free(allocation.FirstIndex, allocation.IndexCount);
+	}
+
+	void GeometryArena::Upload(const GeometryAllocation& allocation, const Vertex* vertices, const uint32_t* indices)
+	{
+		SS_PROFILE_FUNCTION();
+
+		m_Vertices->SetSubData(vertices, allocation.VertexCount * sizeof(Vertex), allocation.BaseVertex * sizeof(Vertex));
+
+		m_PositionScratch.resize(allocation.VertexCount);
+		for (uint32_t i = 0; i < allocation.VertexCount; i++)
+		{
+			m_PositionScratch[i] = vertices[i].Position;
+		}
+		m_Positions->SetSubData(m_PositionScratch.data(), allocation.VertexCount * sizeof(glm::vec3),
+		                        allocation.BaseVertex * sizeof(glm::vec3));
+
+		m_Indices->SetSubData(indices, allocation.IndexCount * sizeof(uint32_t), allocation.FirstIndex * sizeof(uint32_t));
+	}
+
+	void GeometryArena::Grow(const uint32_t vertexCapacity, const uint32_t indexCapacity)
+	{
+		SS_PROFILE_FUNCTION();
+
+		m_VertexAllocator.Grow(vertexCapacity);
+		m_IndexAllocator.Grow(indexCapacity);
+
+		CreateBuffers();
+	}
+
+	uint64_t GeometryArena::GetUsedBytes() const
+	{
+		return static_cast<uint64_t>(m_VertexAllocator.GetUsed()) * VertexBytes +
+			static_cast<uint64_t>(m_IndexAllocator.GetUsed()) * sizeof(uint32_t);
+	}
+
+	void GeometryArena::CreateBuffers()
+	{
+		m_Vertices = VertexBuffer::Create(m_VertexAllocator.GetCapacity() * static_cast<uint32_t>(sizeof(Vertex)));
+		m_Vertices->SetLayout(Material::GetBaseVertexLayout());
+
+		m_Positions = VertexBuffer::Create(m_VertexAllocator.GetCapacity() * static_cast<uint32_t>(sizeof(glm::vec3)));
+		m_Positions->SetLayout({
+			{ShaderDataType::Float3, "a_Position"}
+		});
+
+		m_Indices = IndexBuffer::Create(nullptr, m_IndexAllocator.GetCapacity());
+
+		m_Generation++;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <optional>
+
+#include "Buffer.hpp"
+#include "Mesh.hpp"
+
+#include "Snowstorm/Utility/FreeListAllocator.hpp"
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// Place of a mesh in the arena, in elements rather than bytes so it can go straight into draw commands
+	struct GeometryAllocation
+	{
+		uint32_t BaseVertex = 0;
+		uint32_t VertexCount = 0;
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+	};
+
+	// One vertex and one index buffer shared by all static meshes
+	// Meshes are sub-allocated with free lists, so any number of them can be drawn from a single vertex array.
+	// Positions are kept in a second, tightly packed buffer at the same offsets for passes that read nothing else.
+	// Render thread only.
+	class GeometryArena final : public NonCopyable
+	{
+	public:
+		// GPU memory a vertex takes up across both vertex buffers
+		static constexpr uint32_t VertexBytes = sizeof(Vertex) + sizeof(glm::vec3);
+
+		GeometryArena(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+		std::optional<GeometryAllocation> Allocate(uint32_t vertexCount, uint32_t indexCount);
+		void Free(const GeometryAllocation& allocation);
+
+		// Indices are relative to the allocation's first vertex
+		void Upload(const GeometryAllocation& allocation, const Vertex* vertices, const uint32_t* indices);
+
+		// Replaces both buffers with larger ones, allocations keep their place but their contents are lost and
+		// have to be uploaded again
+		void Grow(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+		[[nodiscard]] const Ref<VertexBuffer>& GetVertexBuffer() const { return m_Vertices; }
+		[[nodiscard]] const Ref<VertexBuffer>& GetPositionBuffer() const { return m_Positions; }
+		[[nodiscard]] const Ref<IndexBuffer>& GetIndexBuffer() const { return m_Indices; }
+
+		[[nodiscard]] uint32_t GetVertexCapacity() const { return m_VertexAllocator.GetCapacity(); }
+		[[nodiscard]] uint32_t GetIndexCapacity() const { return m_IndexAllocator.GetCapacity(); }
+		[[nodiscard]] uint64_t GetUsedBytes() const;
+
+		// Changes whenever the buffers are replaced, vertex arrays referencing them have to be rebuilt
+		[[nodiscard]] uint32_t GetGeneration() const { return m_Generation; }
+
+	private:
+		void CreateBuffers();
+
+		Ref<VertexBuffer> m_Vertices;
+		Ref<VertexBuffer> m_Positions;
+		Ref<IndexBuffer> m_Indices;
+
+		FreeListAllocator m_VertexAllocator;
+		FreeListAllocator m_IndexAllocator;
+
+		std::vector<glm::vec3> m_PositionScratch;
+
+		uint32_t m_Generation = 0;
+	};
+}
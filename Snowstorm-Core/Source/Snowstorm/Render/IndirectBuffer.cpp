@@ -0,0 +1,26 @@
+#include "IndirectBuffer.hpp"
+
+#include "Renderer2D.hpp"
+
+#include "Platform/OpenGL/OpenGLIndirectBuffer.hpp"
+
+namespace Snowstorm
+{
+	std::shared_ptr<IndirectBuffer> IndirectBuffer::Create(uint32_t size)
+	{
+		switch (Renderer2D::GetAPI())
+		{
+		case RendererAPI::API::None:
+			SS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+			return nullptr;
+		case RendererAPI::API::OpenGL:
+			return CreateRef<OpenGLIndirectBuffer>(size);
+		case RendererAPI::API::Vulkan:
+			SS_CORE_ASSERT(false, "VulkanIndirectBuffer is not yet supported!");
+			return nullptr;
+		}
+
+		SS_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+}
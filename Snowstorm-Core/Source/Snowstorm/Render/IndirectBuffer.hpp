@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace Snowstorm
+{
+	// Layout expected by indexed indirect draws on every backend
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t BaseInstance;
+	};
+
+	// Holds draw commands that the GPU reads parameters from, see RendererAPI::DrawIndexedIndirect
+	class IndirectBuffer
+	{
+	public:
+		virtual ~IndirectBuffer() = default;
+
+		// Grows the buffer if the data doesn't fit, growing discards the previous contents
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+		virtual void Bind() const = 0;
+
+		static std::shared_ptr<IndirectBuffer> Create(uint32_t size);
+	};
+}
@@ -3,28 +3,87 @@
 #include <numeric>
 #include <ranges>
 
+#include "MaterialTable.hpp"
+
 namespace Snowstorm
 {
 	Material::Material(Ref<Shader> shader): m_Shader(std::move(shader))
 	{
-		m_Uniforms["u_Color"] = glm::vec4(1.0f); // Default color
+		// Defaults skip validation, shaders without these uniforms simply ignore them
+		FindOrAddUniform("u_Color") = glm::vec4(1.0f); // Default color
 
 		std::vector<int32_t> samplers(MAX_TEXTURE_SLOTS);
 		std::iota(samplers.begin(), samplers.end(), 0);
-		m_Uniforms["u_Textures"] = samplers;
+		FindOrAddUniform("u_Textures") = samplers;
 
 		// Set albedo texture to checkerboard texture
-		m_Textures[0] = Texture2D::Create("assets/textures/Checkerboard.png");
+		SetAlbedoMap(Texture2D::Create("assets/textures/Checkerboard.png"));
+
+		if (m_Shader->HasReflection())
+		{
+			const ShaderReflection& reflection = m_Shader->GetReflection();
+			m_UsesMaterialTable = std::ranges::find(reflection.StorageBlocks, std::string_view(MaterialTable::BlockName),
+			                                        &ShaderReflection::Block::Name) != reflection.StorageBlocks.end();
+
+			// Without sampler uniforms the textures can only come from the table's handles
+			m_UsesBindlessTextures = m_UsesMaterialTable &&
+				std::ranges::none_of(reflection.Uniforms, &ShaderReflection::Uniform::Sampler);
+		}
+
+		ValidateLayouts();
+	}
+
+	void Material::SetTexture(const uint32_t slot, Ref<Texture> texture)
+	{
+		m_Textures[slot] = std::move(texture);
+		m_Version++;
+
+		m_TextureSetKey = 0;
+		for (const Ref<Texture>& slotTexture : m_Textures)
+		{
+			const size_t hash = std::hash<const Texture*>{}(slotTexture.get());
+			m_TextureSetKey ^= hash + 0x9e3779b9 + (m_TextureSetKey << 6) + (m_TextureSetKey >> 2);
+		}
+	}
+
+	bool Material::CanShareDraws(const Material& other) const
+	{
+		if (this == &other)
+		{
+			return true;
+		}
+
+		if (m_Shader != other.m_Shader || !m_UsesMaterialTable || m_HasLooseUniforms || other.m_HasLooseUniforms)
+		{
+			return false;
+		}
+
+		return m_UsesBindlessTextures || m_Textures == other.m_Textures;
 	}
 
-	void Material::Bind() const
+	const void* Material::GetBatchKey() const
 	{
-		m_Shader->Bind();
+		if (m_UsesBindlessTextures && !m_HasLooseUniforms)
+		{
+			return m_Shader.get();
+		}
+
+		return this;
+	}
+
+	void Material::Bind(RenderStateCache& state) const
+	{
+		state.BindShader(m_Shader);
 
 		// Bind all stored uniforms
-		for (const auto& [name, value] : m_Uniforms)
+		for (const MaterialUniform& uniform : m_Uniforms)
 		{
-			ApplyUniform(name, value);
+			std::visit([&](auto&& v) { state.SetUniform(uniform.Handle, v); }, uniform.Value);
+		}
+
+		if (m_UsesBindlessTextures)
+		{
+			return;
 		}
 
 		for (uint32_t i = 0; i < m_Textures.size(); i++)
@@ -34,19 +93,37 @@ namespace Snowstorm
 				continue;
 			}
 
-			m_Textures[i]->Bind(i);
+			state.BindTexture(i, m_Textures[i]);
 		}
 	}
 
-	std::vector<BufferElement> Material::GetVertexLayout() const
+	const std::vector<BufferElement>& Material::GetBaseVertexLayout()
 	{
-		// Base attributes (Every mesh should have these)
-		std::vector<BufferElement> layout = {
+		// Matches Vertex, every mesh has these
+		static const std::vector<BufferElement> layout = {
 			{ShaderDataType::Float3, "a_Position"},
 			{ShaderDataType::Float3, "a_Normal"},
 			{ShaderDataType::Float2, "a_TexCoord"}
 		};
 
+		return layout;
+	}
+
+	const std::vector<BufferElement>& Material::GetBaseInstanceLayout()
+	{
+		// Matches MeshInstanceData
+		static const std::vector<BufferElement> layout = {
+			{ShaderDataType::Mat4, "a_ModelMatrix", true},
+			{ShaderDataType::Float, "a_MaterialIndex", true} // Record in the MaterialTable
+		};
+
+		return layout;
+	}
+
+	std::vector<BufferElement> Material::GetVertexLayout() const
+	{
+		std::vector<BufferElement> layout = GetBaseVertexLayout();
+
 		// Add extra attributes dynamically
 		layout.insert(layout.end(), m_ExtraVertexAttributes.begin(), m_ExtraVertexAttributes.end());
 
@@ -55,10 +132,7 @@ namespace Snowstorm
 
 	std::vector<BufferElement> Material::GetInstanceLayout() const
 	{
-		// Base attributes (Every mesh should have these)
-		std::vector<BufferElement> layout = {
-			{ShaderDataType::Mat4, "a_ModelMatrix", true},
-		};
+		std::vector<BufferElement> layout = GetBaseInstanceLayout();
 
 		// Add extra attributes dynamically
 		layout.insert(layout.end(), m_ExtraInstanceAttributes.begin(), m_ExtraInstanceAttributes.end());
@@ -66,8 +140,95 @@ namespace Snowstorm
 		return layout;
 	}
 
-	void Material::ApplyUniform(const std::string& name, const Shader::UniformValue& value) const
+	void Material::AddVertexAttribute(const BufferElement& attribute)
 	{
-		std::visit([&](auto&& v) { m_Shader->SetUniform(name, v); }, value);
+		SS_CORE_WARN("The geometry arena can't supply vertex attribute '{0}', meshes of this material won't be drawn",
+		             attribute.Name);
+		m_ExtraVertexAttributes.push_back(attribute);
+	}
+
+	void Material::AddInstanceAttribute(const BufferElement& attribute)
+	{
+		SS_CORE_WARN("The instance stream can't supply attribute '{0}', meshes of this material won't be drawn",
+		             attribute.Name);
+		m_ExtraInstanceAttributes.push_back(attribute);
+	}
+
+	bool Material::ValidateLayouts() const
+	{
+		if (!m_Shader->HasReflection())
+		{
+			return true;
+		}
+
+		const std::vector<BufferElement> vertexLayout = GetVertexLayout();
+		const std::vector<BufferElement> instanceLayout = GetInstanceLayout();
+
+		bool valid = true;
+		for (const ShaderReflection::Attribute& attribute : m_Shader->GetReflection().Attributes)
+		{
+			auto it = std::ranges::find(vertexLayout, attribute.Name, &BufferElement::Name);
+			if (it == vertexLayout.end())
+			{
+				it = std::ranges::find(instanceLayout, attribute.Name, &BufferElement::Name);
+				if (it == instanceLayout.end())
+				{
+					SS_CORE_WARN("Shader '{0}' reads attribute '{1}' that the material's layouts don't provide",
+					             m_Shader->GetPath(), attribute.Name);
+					valid = false;
+					continue;
+				}
+			}
+
+			if (it->Type != attribute.Type)
+			{
+				SS_CORE_WARN("Attribute '{0}' of shader '{1}' has a different type than in the material's layouts",
+				             attribute.Name, m_Shader->GetPath());
+				valid = false;
+			}
+		}
+
+		return valid;
+	}
+
+	Shader::UniformValue& Material::FindOrAddUniform(const std::string& name)
+	{
+		if (const auto it = std::ranges::find(m_Uniforms, name, &MaterialUniform::Name); it != m_Uniforms.end())
+		{
+			return it->Value;
+		}
+
+		return m_Uniforms.emplace_back(name, m_Shader->GetUniformHandle(name)).Value;
+	}
+
+	void Material::ValidateUniform(const std::string& name, const Shader::UniformValue& value) const
+	{
+		if (!m_Shader->HasReflection())
+		{
+			return;
+		}
+
+		const ShaderReflection::Uniform* uniform = m_Shader->GetReflection().FindUniform(name);
+		if (!uniform)
+		{
+			SS_CORE_WARN("Shader '{0}' has no active uniform '{1}'", m_Shader->GetPath(), name);
+			return;
+		}
+
+		const ShaderDataType type = std::visit([]<typename T>(const T&)
+		{
+			if constexpr (std::is_same_v<T, float>) return ShaderDataType::Float;
+			else if constexpr (std::is_same_v<T, glm::vec2>) return ShaderDataType::Float2;
+			else if constexpr (std::is_same_v<T, glm::vec3>) return ShaderDataType::Float3;
+			else if constexpr (std::is_same_v<T, glm::vec4>) return ShaderDataType::Float4;
+			else if constexpr (std::is_same_v<T, glm::mat4>) return ShaderDataType::Mat4;
+			else return ShaderDataType::Int; // int and int arrays
+		}, value);
+
+		if (type != uniform->Type)
+		{
+			SS_CORE_WARN("Uniform '{0}' of shader '{1}' has a different type than the value set", name,
+			             m_Shader->GetPath());
+		}
 	}
 }
@@ -1,10 +1,10 @@
 #pragma once
 
-#pragma once
-
+#include <algorithm>
 #include <array>
 
 #include "Buffer.hpp"
+#include "RenderStateCache.hpp"
 #include "Shader.hpp"
 #include "Texture.hpp"
 #include "Snowstorm/Core/Base.h"
@@ -16,60 +16,125 @@ namespace Snowstorm
 	public:
 		explicit Material(Ref<Shader> shader);
 
-		void Bind() const;
+		// Binds the shader, uniforms and textures, skipping whatever state already matches
+		void Bind(RenderStateCache& state) const;
 
+		// Warns if the shader has no such uniform or declares it with another type
 		template <typename T>
 		void SetUniform(const std::string& name, const T& value)
 		{
-			m_Uniforms[name] = value;
+			Shader::UniformValue& uniform = FindOrAddUniform(name);
+			uniform = value;
+			ValidateUniform(name, uniform);
+			m_Version++;
+
+			// Anything but the color stays a loose uniform even with the MaterialTable
+			m_HasLooseUniforms |= name != "u_Color";
 		}
 
 		[[nodiscard]] Shader::UniformValue GetUniform(const std::string& name) const
 		{
-			SS_CORE_ASSERT(m_Uniforms.contains(name));
-			return m_Uniforms.find(name)->second;
+			const auto it = std::ranges::find(m_Uniforms, name, &MaterialUniform::Name);
+			SS_CORE_ASSERT(it != m_Uniforms.end());
+			return it->Value;
 		}
 
 		// Predefined texture setters (make some sort of enums here)
-		void SetAlbedoMap(Ref<Texture> texture) { m_Textures[0] = std::move(texture); }
+		void SetAlbedoMap(Ref<Texture> texture) { SetTexture(0, std::move(texture)); }
 		Ref<Texture> GetAlbedoMap() { return m_Textures[0]; }
 
-		void SetNormalMap(Ref<Texture> texture) { m_Textures[1] = std::move(texture); }
+		void SetNormalMap(Ref<Texture> texture) { SetTexture(1, std::move(texture)); }
 		Ref<Texture> GetNormalMap() { return m_Textures[1]; }
 
-		void SetMetallicMap(Ref<Texture> texture) { m_Textures[2] = std::move(texture); }
+		void SetMetallicMap(Ref<Texture> texture) { SetTexture(2, std::move(texture)); }
 		Ref<Texture> GetMetallicMap() { return m_Textures[2]; }
 
-		void SetRoughnessMap(Ref<Texture> texture) { m_Textures[3] = std::move(texture); }
+		void SetRoughnessMap(Ref<Texture> texture) { SetTexture(3, std::move(texture)); }
 		Ref<Texture> GetRoughnessMap() { return m_Textures[3]; }
 
-		void SetAOMap(Ref<Texture> texture) { m_Textures[4] = std::move(texture); }
+		void SetAOMap(Ref<Texture> texture) { SetTexture(4, std::move(texture)); }
 		Ref<Texture> GetAOMap() { return m_Textures[4]; }
 
-		void SetTexture(const uint32_t slot, Ref<Texture> texture) { m_Textures[slot] = std::move(texture); }
+		void SetTexture(uint32_t slot, Ref<Texture> texture);
 		[[nodiscard]] Ref<Texture> GetTexture(const uint32_t slot) { return m_Textures[slot]; }
 
-		void SetColor(const glm::vec4& color) { m_Uniforms["u_Color"] = color; }
-		[[nodiscard]] glm::vec4& GetColor() { return std::get<glm::vec4>(m_Uniforms["u_Color"]); }
+		void SetColor(const glm::vec4& color)
+		{
+			FindOrAddUniform("u_Color") = color;
+			m_Version++;
+		}
+
+		// The color may be modified through the reference, so the material counts as changed
+		[[nodiscard]] glm::vec4& GetColor()
+		{
+			m_Version++;
+			return std::get<glm::vec4>(FindOrAddUniform("u_Color"));
+		}
+
+		// Changes whenever a uniform, the color or a texture is set, see MaterialTable
+		[[nodiscard]] uint32_t GetVersion() const { return m_Version; }
+
+		// Whether the shader reads the color from the MaterialTable instead of u_Color
+		[[nodiscard]] bool UsesMaterialTable() const { return m_UsesMaterialTable; }
+		// Whether it samples the albedo map through the table's bindless handle as well, in which case materials
+		// of the same shader are interchangeable when drawing
+		[[nodiscard]] bool UsesBindlessTextures() const { return m_UsesBindlessTextures; }
+
+		// Orders materials so ones binding the same textures end up next to each other
+		[[nodiscard]] size_t GetTextureSetKey() const { return m_TextureSetKey; }
+
+		// Whether binding either material draws the other correctly, which needs all their differences to be in the
+		// MaterialTable
+		[[nodiscard]] bool CanShareDraws(const Material& other) const;
+
+		// Identifies the materials whose instances can share a batch: the shader if all of the material's state is in
+		// the MaterialTable, otherwise the material itself
+		[[nodiscard]] const void* GetBatchKey() const;
 
 		[[nodiscard]] Ref<Shader> GetShader() const { return m_Shader; }
 
+		// Checks that the vertex and instance layouts provide every attribute the shader reads, with matching types
+		bool ValidateLayouts() const;
+
+		// Attributes the geometry arena and the renderer's instance stream supply, the only ones bound when drawing
+		[[nodiscard]] static const std::vector<BufferElement>& GetBaseVertexLayout();
+		[[nodiscard]] static const std::vector<BufferElement>& GetBaseInstanceLayout();
+
 		// Vertex & Instance Layout Functions
 		[[nodiscard]] std::vector<BufferElement> GetVertexLayout() const;
 		[[nodiscard]] std::vector<BufferElement> GetInstanceLayout() const;
 
-		void AddVertexAttribute(const BufferElement& attribute) { m_ExtraVertexAttributes.push_back(attribute); }
-		void AddInstanceAttribute(const BufferElement& attribute) { m_ExtraInstanceAttributes.push_back(attribute); }
+		// Nothing supplies extra attributes yet, so the renderer skips materials that declare any
+		void AddVertexAttribute(const BufferElement& attribute);
+		void AddInstanceAttribute(const BufferElement& attribute);
+		[[nodiscard]] bool HasExtraAttributes() const
+		{
+			return !m_ExtraVertexAttributes.empty() || !m_ExtraInstanceAttributes.empty();
+		}
 
 	private:
 		static constexpr uint32_t MAX_TEXTURE_SLOTS = 32;
 
+		struct MaterialUniform
+		{
+			std::string Name;
+			UniformHandle Handle;
+			Shader::UniformValue Value;
+		};
+
+		Shader::UniformValue& FindOrAddUniform(const std::string& name);
+		void ValidateUniform(const std::string& name, const Shader::UniformValue& value) const;
+
 		Ref<Shader> m_Shader;
-		std::unordered_map<std::string, Shader::UniformValue> m_Uniforms;
+		std::vector<MaterialUniform> m_Uniforms; // Few per material, so a linear search beats hashing
 		std::vector<BufferElement> m_ExtraVertexAttributes;
 		std::vector<BufferElement> m_ExtraInstanceAttributes;
 		std::array<Ref<Texture>, MAX_TEXTURE_SLOTS> m_Textures;
+		size_t m_TextureSetKey = 0;
 
-		void ApplyUniform(const std::string& name, const Shader::UniformValue& value) const;
+		uint32_t m_Version = 0;
+		bool m_UsesMaterialTable = false;
+		bool m_UsesBindlessTextures = false;
+		bool m_HasLooseUniforms = false;
 	};
 }
@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "MaterialTable.hpp"
+
+#include <algorithm>
+
+namespace Snowstorm
+{
+	namespace
+	{
+		constexpr uint32_t InitialCapacity = 1024;
+
+		// Destroyed materials are looked for every this many uploads
+		constexpr uint32_t ReleaseInterval = 64;
+	}
+
+	MaterialTable::MaterialTable()
+		: m_BufferCapacity(InitialCapacity)
+	{
+		m_Buffer = StorageBuffer::Create(m_BufferCapacity * sizeof(MaterialRecord), Binding);
+	}
+
+	uint32_t MaterialTable::Acquire(const Ref<Material>& material)
+	{
+		auto [it, inserted] = m_Entries.try_emplace(material.get());
+		Entry& entry = it->second;
+
+		if (!inserted && entry.Source.expired())
+		{
+			// A destroyed material left its record behind at this address
+			m_FreeIndices.push_back(entry.Index);
+			inserted = true;
+		}
+
+		if (inserted)
+		{
+			entry.Source = material;
+			if (m_FreeIndices.empty())
+			{
+				entry.Index = static_cast<uint32_t>(m_Records.size());
+				m_Records.emplace_back();
+			}
+			else
+			{
+				entry.Index = m_FreeIndices.back();
+				m_FreeIndices.pop_back();
+			}
+		}
+		else if (entry.Version == material->GetVersion())
+		{
+			return entry.Index;
+		}
+
+		entry.Version = material->GetVersion();
+
+		MaterialRecord& record = m_Records[entry.Index];
+		record.Color = std::get<glm::vec4>(material->GetUniform("u_Color"));
+
+		const Ref<Texture> albedoMap = material->GetAlbedoMap();
+		record.AlbedoMap = material->UsesBindlessTextures() && albedoMap ? albedoMap->GetBindlessHandle() : 0;
+
+		m_DirtyIndices.push_back(entry.Index);
+		return entry.Index;
+	}
+
+	void MaterialTable::Upload()
+	{
+		SS_PROFILE_FUNCTION();
+
+		if (++m_UploadCount % ReleaseInterval == 0)
+		{
+			ReleaseExpired();
+		}
+
+		constexpr auto recordSize = static_cast<uint32_t>(sizeof(MaterialRecord));
+
+		if (m_Records.size() > m_BufferCapacity)
+		{
+			// Growing discards the buffer's contents, so everything goes up again
+			const auto size = static_cast<uint32_t>(m_Records.size()) * recordSize;
+			m_Buffer->SetData(m_Records.data(), size);
+			m_BufferCapacity = std::max(static_cast<uint32_t>(m_Records.size()), m_BufferCapacity * 2);
+
+			m_Stats.UploadedRecords += static_cast<uint32_t>(m_Records.size());
+			m_Stats.UploadBytes += size;
+		}
+		else if (!m_DirtyIndices.empty())
+		{
+			// One write per run of adjacent records
+			std::ranges::sort(m_DirtyIndices);
+			const auto [last, end] = std::ranges::unique(m_DirtyIndices);
+			m_DirtyIndices.erase(last, end);
+
+			for (size_t first = 0; first < m_DirtyIndices.size();)
+			{
+				size_t next = first + 1;
+				while (next < m_DirtyIndices.size() && m_DirtyIndices[next] == m_DirtyIndices[next - 1] + 1)
+				{
+					next++;
+				}
+
+				const auto count = static_cast<uint32_t>(next - first);
+				m_Buffer->SetData(&m_Records[m_DirtyIndices[first]], count * recordSize,
+				                  m_DirtyIndices[first] * recordSize);
+
+				m_Stats.UploadedRecords += count;
+				m_Stats.UploadBytes += count * recordSize;
+				first = next;
+			}
+		}
+
+		m_DirtyIndices.clear();
+		m_Buffer->Bind();
+	}
+
+	void MaterialTable::ReleaseExpired()
+	{
+		std::erase_if(m_Entries, [&](const auto& pair)
+		{
+			if (!pair.second.Source.expired())
+			{
+				return false;
+			}
+
+			m_FreeIndices.push_back(pair.second.Index);
+			return true;
+		});
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Material.hpp"
+#include "StorageBuffer.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// Parameters of one material as shaders read them, std430 layout
+	struct MaterialRecord
+	{
+		glm::vec4 Color{1.0f};
+		uint64_t AlbedoMap = 0; // Bindless handle, 0 unless the material uses bindless textures
+		uint64_t Padding = 0;
+	};
+
+	static_assert(sizeof(MaterialRecord) % 16 == 0, "std430 arrays of MaterialRecord are 16 byte aligned");
+
+	// Packs the parameters of every material drawn into one storage buffer
+	// Each material keeps its record index for as long as it lives, and only records of materials that changed
+	// since the last upload are written again. Shaders opt in by declaring the MaterialData block, see
+	// Material::UsesMaterialTable. Render thread only.
+	class MaterialTable final : public NonCopyable
+	{
+	public:
+		static constexpr uint32_t Binding = 2;
+		static constexpr const char* BlockName = "MaterialData";
+
+		MaterialTable();
+
+		// Index of the material's record, refreshed from the material if it changed
+		uint32_t Acquire(const Ref<Material>& material);
+
+		// Writes the records changed since the last upload and binds the buffer
+		void Upload();
+
+		struct Statistics
+		{
+			uint32_t UploadedRecords = 0;
+			uint64_t UploadBytes = 0;
+		};
+
+		void ResetStats() { m_Stats = {}; }
+		[[nodiscard]] Statistics GetStats() const { return m_Stats; }
+
+	private:
+		struct Entry
+		{
+			std::weak_ptr<Material> Source; // Expired when the material was destroyed, its address may then be reused
+			uint32_t Index = 0;
+			uint32_t Version = 0;
+		};
+
+		void ReleaseExpired();
+
+		std::unordered_map<const Material*, Entry> m_Entries;
+		std::vector<MaterialRecord> m_Records;
+		std::vector<uint32_t> m_FreeIndices;
+		std::vector<uint32_t> m_DirtyIndices;
+
+		Ref<StorageBuffer> m_Buffer;
+		uint32_t m_BufferCapacity; // In records
+		uint32_t m_UploadCount = 0;
+
+		Statistics m_Stats;
+	};
+}
@@ -0,0 +1,26 @@
+#include "pch.h"
+#include "Mesh.hpp"
+
+#include <algorithm>
+
+namespace Snowstorm
+{
+	uint32_t Mesh::SelectLOD(const float screenSize, const uint32_t currentLOD, const float maxScreenError,
+	                         const float hysteresis) const
+	{
+		// The error of a level covers at most Error * screenSize of the viewport
+		uint32_t level = std::min(currentLOD, GetLODCount() - 1);
+
+		while (level + 1 < GetLODCount() && m_LODs[level].Error * screenSize * (1.0f + hysteresis) <= maxScreenError)
+		{
+			level++;
+		}
+
+		while (level > 0 && m_LODs[level - 1].Error * screenSize * (1.0f - hysteresis) > maxScreenError)
+		{
+			level--;
+		}
+
+		return level;
+	}
+}
@@ -3,6 +3,10 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+#include "Bounds.hpp"
+
+#include "Snowstorm/Core/Base.h"
+
 namespace Snowstorm
 {
 	struct Vertex
@@ -12,12 +16,30 @@ namespace Snowstorm
 		glm::vec2 TexCoord;
 	};
 
+	class Mesh;
+
+	// Simplified version of a mesh, see SimplifyMesh
+	struct MeshLOD
+	{
+		Ref<Mesh> LODMesh;
+		float Error = 0.0f; // Relative to the full mesh's largest extent
+	};
+
 	class Mesh
 	{
 	public:
 		Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
 			: m_Vertices(std::move(vertices)), m_Indices(std::move(indices))
 		{
+			if (!m_Vertices.empty())
+			{
+				m_Bounds = {m_Vertices[0].Position, m_Vertices[0].Position};
+				for (const Vertex& vertex : m_Vertices)
+				{
+					m_Bounds.Min = min(m_Bounds.Min, vertex.Position);
+					m_Bounds.Max = max(m_Bounds.Max, vertex.Position);
+				}
+			}
 		}
 
 		[[nodiscard]] const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
@@ -25,8 +47,29 @@ namespace Snowstorm
 		[[nodiscard]] const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
 		[[nodiscard]] uint32_t GetIndexCount() const { return static_cast<uint32_t>(m_Indices.size()); }
 
+		// Local space bounds of the vertices
+		[[nodiscard]] const AABB& GetBounds() const { return m_Bounds; }
+
+		// Levels of detail from finest to coarsest, level 0 is the mesh itself
+		void SetLODs(std::vector<MeshLOD> lods) { m_LODs = std::move(lods); }
+		[[nodiscard]] uint32_t GetLODCount() const { return static_cast<uint32_t>(m_LODs.size()) + 1; }
+
+		[[nodiscard]] const MeshLOD& GetLOD(const uint32_t level) const
+		{
+			SS_CORE_ASSERT(level > 0 && level <= m_LODs.size(), "Level 0 is the mesh itself!");
+			return m_LODs[level - 1];
+		}
+
+		// Coarsest level whose error covers at most maxScreenError of the viewport height, for bounds covering
+		// screenSize of it. Only moves away from currentLOD once the size is past the switching point by the
+		// hysteresis fraction, so meshes near it don't flicker between levels.
+		[[nodiscard]] uint32_t SelectLOD(float screenSize, uint32_t currentLOD, float maxScreenError,
+		                                 float hysteresis) const;
+
 	private:
 		std::vector<Vertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;
+		AABB m_Bounds;
+		std::vector<MeshLOD> m_LODs;
 	};
 }
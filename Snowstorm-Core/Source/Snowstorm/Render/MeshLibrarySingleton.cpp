@@ -4,10 +4,51 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include "MeshSimplifier.hpp"
 #include "Snowstorm/Core/Log.h"
+#include "Snowstorm/Utility/FileSystem.hpp"
 
 namespace Snowstorm
 {
+	namespace
+	{
+		void GenerateLODs(Mesh& mesh, const MeshLODSettings& settings)
+		{
+			if (settings.MaxLevels == 0)
+			{
+				return;
+			}
+
+			std::vector<MeshLOD> lods;
+
+			// Every level is simplified from the full mesh, so its error is measured against the original surface
+			float ratio = 1.0f;
+			uint32_t previousIndexCount = mesh.GetIndexCount();
+
+			for (uint32_t level = 1; level <= settings.MaxLevels; level++)
+			{
+				ratio *= settings.Ratio;
+				SimplifiedMesh simplified = SimplifyMesh(mesh, ratio, settings.TargetError);
+
+				// The error limit stopped the simplifier early, coarser levels wouldn't get any smaller
+				if (simplified.Indices.empty() || simplified.Indices.size() > previousIndexCount * 9 / 10)
+				{
+					break;
+				}
+
+				previousIndexCount = static_cast<uint32_t>(simplified.Indices.size());
+				lods.push_back({
+					CreateRef<Mesh>(std::move(simplified.Vertices), std::move(simplified.Indices)), simplified.Error
+				});
+			}
+
+			SS_CORE_INFO("Generated {0} levels of detail, coarsest has {1} of {2} triangles", lods.size(),
+			             previousIndexCount / 3, mesh.GetIndexCount() / 3);
+
+			mesh.SetLODs(std::move(lods));
+		}
+	}
+
 	Ref<Mesh> MeshLibrarySingleton::Load(const std::string& filepath)
 	{
 		if (m_Meshes.contains(filepath))
@@ -15,6 +56,37 @@ namespace Snowstorm
 			return m_Meshes[filepath];
 		}
 
+		Ref<Mesh> mesh = LoadFile(filepath);
+		if (mesh)
+		{
+			m_Meshes[filepath] = mesh;
+		}
+		return mesh;
+	}
+
+	std::vector<MeshLibrarySingleton::Replacement> MeshLibrarySingleton::Reload(const std::string& path)
+	{
+		std::vector<Replacement> replacements;
+		for (auto& [filepath, mesh] : m_Meshes)
+		{
+			if (!IsSameFile(filepath, path))
+			{
+				continue;
+			}
+
+			// A file that doesn't import keeps its previous mesh, it's most likely still being written
+			if (Ref<Mesh> reloaded = LoadFile(filepath))
+			{
+				replacements.push_back({mesh, reloaded});
+				mesh = std::move(reloaded);
+			}
+		}
+
+		return replacements;
+	}
+
+	Ref<Mesh> MeshLibrarySingleton::LoadFile(const std::string& filepath) const
+	{
 		Assimp::Importer importer;
 		const aiScene* scene = importer.ReadFile(filepath,
 		                                         aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices);
@@ -69,8 +141,9 @@ namespace Snowstorm
 			}
 		}
 
-		Ref<Mesh> mesh = CreateRef<Mesh>(vertices, indices);
-		m_Meshes[filepath] = mesh;
+		Ref<Mesh> mesh = CreateRef<Mesh>(std::move(vertices), std::move(indices));
+		GenerateLODs(*mesh, m_LODSettings);
+
 		return mesh;
 	}
 
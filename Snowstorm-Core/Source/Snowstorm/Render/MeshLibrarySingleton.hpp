@@ -8,16 +8,42 @@
 
 namespace Snowstorm
 {
+	// How the levels of detail of loaded meshes are generated
+	struct MeshLODSettings
+	{
+		uint32_t MaxLevels = 3; // Besides the full mesh, 0 disables generation
+		float Ratio = 0.5f; // Triangle count of each level relative to the previous one
+		float TargetError = 0.02f; // Largest simplification error, relative to the mesh's largest extent
+	};
+
 	class MeshLibrarySingleton final : public Singleton
 	{
 	public:
+		// Generates levels of detail for the mesh as configured by SetLODSettings
 		Ref<Mesh> Load(const std::string& filepath);
 		Ref<Mesh> CreateQuad();
 
 		void Clear();
 		bool Remove(const std::string& filepath);
 
+		struct Replacement
+		{
+			Ref<Mesh> Previous;
+			Ref<Mesh> Current;
+		};
+
+		// Loads the meshes that came from the file at path again. Whoever still holds a previous mesh has to be
+		// pointed at its replacement, the previous one stays intact until released.
+		std::vector<Replacement> Reload(const std::string& path);
+
+		// Applies to meshes loaded afterward
+		void SetLODSettings(const MeshLODSettings& settings) { m_LODSettings = settings; }
+		[[nodiscard]] const MeshLODSettings& GetLODSettings() const { return m_LODSettings; }
+
 	private:
+		[[nodiscard]] Ref<Mesh> LoadFile(const std::string& filepath) const;
+
 		std::unordered_map<std::string, Ref<Mesh>> m_Meshes;
+		MeshLODSettings m_LODSettings;
 	};
 }
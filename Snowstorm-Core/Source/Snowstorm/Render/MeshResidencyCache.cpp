@@ -0,0 +1,139 @@
+#include "pch.h"
+#include "MeshResidencyCache.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Initial arena size, it doubles whenever the meshes of a scene don't fit
+		constexpr uint32_t InitialArenaVertices = 256 * 1024;
+		constexpr uint32_t InitialArenaIndices = 1024 * 1024;
+	}
+
+	MeshResidencyCache::MeshResidencyCache(const uint64_t budgetBytes)
+		: m_Arena(InitialArenaVertices, InitialArenaIndices), m_Budget(budgetBytes)
+	{
+	}
+
+	void MeshResidencyCache::BeginScene()
+	{
+		m_SceneIndex++;
+	}
+
+	const ResidentMesh& MeshResidencyCache::Acquire(const Ref<Mesh>& mesh)
+	{
+		if (const auto it = m_Meshes.find(mesh.get()); it != m_Meshes.end())
+		{
+			if (Entry& entry = it->second; !entry.Source.expired())
+			{
+				m_LRU.splice(m_LRU.begin(), m_LRU, entry.LRUPosition);
+				entry.Resident.LastUsedScene = m_SceneIndex;
+				return entry.Resident;
+			}
+
+			// A destroyed mesh left its geometry behind at this address
+			Release(it);
+		}
+
+		SS_PROFILE_FUNCTION();
+
+		const GeometryAllocation geometry = AllocateGeometry(mesh->GetVertexCount(), mesh->GetIndexCount());
+		m_Arena.Upload(geometry, mesh->GetVertices().data(), mesh->GetIndices().data());
+
+		Entry& entry = m_Meshes[mesh.get()];
+		entry.Source = mesh;
+		entry.Resident.Geometry = geometry;
+		entry.Resident.SizeBytes = static_cast<uint64_t>(geometry.VertexCount) * GeometryArena::VertexBytes +
+			static_cast<uint64_t>(geometry.IndexCount) * sizeof(uint32_t);
+		entry.Resident.LastUsedScene = m_SceneIndex;
+
+		m_LRU.push_front(mesh.get());
+		entry.LRUPosition = m_LRU.begin();
+		m_ResidentBytes += entry.Resident.SizeBytes;
+
+		m_Stats.Uploads++;
+		m_Stats.UploadBytes += entry.Resident.SizeBytes;
+
+		while (m_ResidentBytes > m_Budget && EvictLeastRecentlyUsed())
+		{
+		}
+
+		return entry.Resident;
+	}
+
+	void MeshResidencyCache::SetBudget(const uint64_t budgetBytes)
+	{
+		m_Budget = budgetBytes;
+		while (m_ResidentBytes > m_Budget && EvictLeastRecentlyUsed())
+		{
+		}
+	}
+
+	GeometryAllocation MeshResidencyCache::AllocateGeometry(const uint32_t vertexCount, const uint32_t indexCount)
+	{
+		// Make room by evicting meshes this scene doesn't need
+		do
+		{
+			if (const auto allocation = m_Arena.Allocate(vertexCount, indexCount))
+			{
+				return *allocation;
+			}
+		}
+		while (EvictLeastRecentlyUsed());
+
+		// Everything left is in use, grow the arena and upload the resident meshes again
+		m_Arena.Grow(std::bit_ceil(std::max(m_Arena.GetVertexCapacity() * 2, m_Arena.GetVertexCapacity() + vertexCount)),
+		             std::bit_ceil(std::max(m_Arena.GetIndexCapacity() * 2, m_Arena.GetIndexCapacity() + indexCount)));
+
+		SS_CORE_INFO("Grew the mesh geometry arena to {0} vertices and {1} indices", m_Arena.GetVertexCapacity(),
+		             m_Arena.GetIndexCapacity());
+
+		for (auto it = m_Meshes.begin(); it != m_Meshes.end();)
+		{
+			if (const Ref<Mesh> source = it->second.Source.lock())
+			{
+				m_Arena.Upload(it->second.Resident.Geometry, source->GetVertices().data(), source->GetIndices().data());
+				m_Stats.UploadBytes += it->second.Resident.SizeBytes;
+				++it;
+			}
+			else
+			{
+				Release(it++);
+			}
+		}
+
+		const auto allocation = m_Arena.Allocate(vertexCount, indexCount);
+		SS_CORE_ASSERT(allocation, "Geometry arena is still too small after growing!");
+		return *allocation;
+	}
+
+	void MeshResidencyCache::Release(const std::unordered_map<const Mesh*, Entry>::iterator it)
+	{
+		m_Arena.Free(it->second.Resident.Geometry);
+		m_ResidentBytes -= it->second.Resident.SizeBytes;
+		m_LRU.erase(it->second.LRUPosition);
+		m_Meshes.erase(it);
+	}
+
+	bool MeshResidencyCache::EvictLeastRecentlyUsed()
+	{
+		if (m_LRU.empty())
+		{
+			return false;
+		}
+
+		// Everything else was used more recently, so once the last mesh belongs to this scene all of them do
+		const auto it = m_Meshes.find(m_LRU.back());
+		if (it->second.Resident.LastUsedScene == m_SceneIndex)
+		{
+			return false;
+		}
+
+		Release(it);
+		m_Stats.Evictions++;
+		return true;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "GeometryArena.hpp"
+#include "Mesh.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// GPU copy of a mesh, uploaded once and reused by every scene that draws it
+	struct ResidentMesh
+	{
+		GeometryAllocation Geometry;
+		uint64_t SizeBytes = 0;
+		uint64_t LastUsedScene = 0;
+	};
+
+	// Keeps meshes in a shared GeometryArena across scenes
+	// Meshes are uploaded on first use and evicted least recently used first once the resident size exceeds the
+	// budget or the arena runs out of space. Meshes used in the current scene are never evicted: the budget can be
+	// exceeded temporarily and the arena grows instead. Render thread only.
+	class MeshResidencyCache final : public NonCopyable
+	{
+	public:
+		static constexpr uint64_t DefaultBudget = 256ull * 1024 * 1024;
+
+		explicit MeshResidencyCache(uint64_t budgetBytes = DefaultBudget);
+
+		void BeginScene();
+
+		// Uploads the mesh if it isn't resident. The reference stays valid until the next call.
+		const ResidentMesh& Acquire(const Ref<Mesh>& mesh);
+
+		[[nodiscard]] const GeometryArena& GetArena() const { return m_Arena; }
+
+		void SetBudget(uint64_t budgetBytes);
+		[[nodiscard]] uint64_t GetBudget() const { return m_Budget; }
+
+		[[nodiscard]] uint32_t GetResidentCount() const { return static_cast<uint32_t>(m_Meshes.size()); }
+		[[nodiscard]] uint64_t GetResidentBytes() const { return m_ResidentBytes; }
+
+		struct Statistics
+		{
+			uint32_t Uploads = 0;
+			uint64_t UploadBytes = 0;
+			uint32_t Evictions = 0;
+		};
+
+		void ResetStats() { m_Stats = {}; }
+		[[nodiscard]] Statistics GetStats() const { return m_Stats; }
+
+	private:
+		struct Entry
+		{
+			std::weak_ptr<Mesh> Source; // Expired when the mesh was destroyed, its address may then be reused
+			ResidentMesh Resident;
+			std::list<const Mesh*>::iterator LRUPosition;
+		};
+
+		GeometryAllocation AllocateGeometry(uint32_t vertexCount, uint32_t indexCount);
+		void Release(std::unordered_map<const Mesh*, Entry>::iterator it);
+
+		// Evicts the least recently used mesh unless the current scene uses it, returns whether one was evicted
+		bool EvictLeastRecentlyUsed();
+
+		GeometryArena m_Arena;
+
+		std::unordered_map<const Mesh*, Entry> m_Meshes;
+		std::list<const Mesh*> m_LRU; // Most recently used first
+
+		uint64_t m_Budget;
+		uint64_t m_ResidentBytes = 0;
+		uint64_t m_SceneIndex = 0;
+
+		Statistics m_Stats;
+	};
+}
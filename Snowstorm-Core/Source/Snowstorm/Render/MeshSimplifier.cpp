@@ -0,0 +1,343 @@
+#include "pch.h"
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Sum of squared distances to a set of planes, weighted by the area of the triangles they came from
+		struct Quadric
+		{
+			double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+			double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+			double C = 0.0;
+			double Weight = 0.0;
+
+			static Quadric FromTriangle(const glm::dvec3& p0, const glm::dvec3& p1, const glm::dvec3& p2)
+			{
+				Quadric q;
+
+				const glm::dvec3 normal = cross(p1 - p0, p2 - p0);
+				const double length = glm::length(normal);
+				if (length == 0.0)
+				{
+					return q;
+				}
+
+				const glm::dvec3 n = normal / length;
+				const double d = -dot(n, p0);
+				const double w = length * 0.5;
+
+				q.A00 = n.x * n.x * w;
+				q.A01 = n.x * n.y * w;
+				q.A02 = n.x * n.z * w;
+				q.A11 = n.y * n.y * w;
+				q.A12 = n.y * n.z * w;
+				q.A22 = n.z * n.z * w;
+				q.B0 = n.x * d * w;
+				q.B1 = n.y * d * w;
+				q.B2 = n.z * d * w;
+				q.C = d * d * w;
+				q.Weight = w;
+				return q;
+			}
+
+			void Add(const Quadric& other)
+			{
+				A00 += other.A00;
+				A01 += other.A01;
+				A02 += other.A02;
+				A11 += other.A11;
+				A12 += other.A12;
+				A22 += other.A22;
+				B0 += other.B0;
+				B1 += other.B1;
+				B2 += other.B2;
+				C += other.C;
+				Weight += other.Weight;
+			}
+
+			[[nodiscard]] double Evaluate(const glm::dvec3& p) const
+			{
+				const double value = A00 * p.x * p.x + A11 * p.y * p.y + A22 * p.z * p.z +
+					2.0 * (A01 * p.x * p.y + A02 * p.x * p.z + A12 * p.y * p.z) +
+					2.0 * (B0 * p.x + B1 * p.y + B2 * p.z) + C;
+
+				return std::abs(value);
+			}
+		};
+
+		struct Collapse
+		{
+			uint32_t From; // Removed vertex, never locked
+			uint32_t To;
+			double Error; // Mean squared distance
+		};
+
+		struct PositionHash
+		{
+			size_t operator()(const glm::vec3& p) const
+			{
+				const size_t x = std::bit_cast<uint32_t>(p.x);
+				const size_t y = std::bit_cast<uint32_t>(p.y);
+				const size_t z = std::bit_cast<uint32_t>(p.z);
+				return (x * 73856093) ^ (y * 19349663) ^ (z * 83492791);
+			}
+		};
+
+		uint64_t EdgeKey(const uint32_t a, const uint32_t b)
+		{
+			return static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+		}
+	}
+
+	SimplifiedMesh SimplifyMesh(const Mesh& mesh, const float targetRatio, const float targetError)
+	{
+		SS_PROFILE_FUNCTION();
+
+		const std::vector<Vertex>& vertices = mesh.GetVertices();
+		const auto vertexCount = static_cast<uint32_t>(vertices.size());
+
+		std::vector<uint32_t> indices = mesh.GetIndices();
+		const size_t targetTriangleCount = static_cast<size_t>(static_cast<float>(indices.size() / 3) * targetRatio);
+
+		// Vertices at the same position are wedges of one corner, split by their normals or texture coordinates
+		std::vector<uint32_t> positionOf(vertexCount);
+		std::vector<uint32_t> wedgeCount(vertexCount, 0);
+		{
+			std::unordered_map<glm::vec3, uint32_t, PositionHash> firstAtPosition;
+			firstAtPosition.reserve(vertexCount);
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				positionOf[i] = firstAtPosition.try_emplace(vertices[i].Position, i).first->second;
+				wedgeCount[positionOf[i]]++;
+			}
+		}
+
+		// Border edges belong to a single triangle
+		std::unordered_map<uint64_t, uint32_t> edgeUses;
+		edgeUses.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (uint32_t e = 0; e < 3; e++)
+			{
+				edgeUses[EdgeKey(positionOf[indices[i + e]], positionOf[indices[i + (e + 1) % 3]])]++;
+			}
+		}
+
+		// Seam and border vertices never move, a vertex that isn't locked is the only wedge at its position
+		std::vector<uint8_t> locked(vertexCount, 0);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			locked[i] = wedgeCount[positionOf[i]] > 1;
+		}
+		for (const auto& [key, uses] : edgeUses)
+		{
+			if (uses == 1)
+			{
+				locked[key >> 32] = 1;
+				locked[key & 0xFFFFFFFF] = 1;
+			}
+		}
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			locked[i] = locked[positionOf[i]];
+		}
+
+		const auto position = [&](const uint32_t vertex) { return glm::dvec3(vertices[vertex].Position); };
+
+		// Quadrics are kept per position, so seam wedges share one
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const Quadric q = Quadric::FromTriangle(position(indices[i]), position(indices[i + 1]), position(indices[i + 2]));
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				quadrics[positionOf[indices[i + c]]].Add(q);
+			}
+		}
+
+		const glm::vec3 extents = mesh.GetBounds().Max - mesh.GetBounds().Min;
+		const double scale = std::max({extents.x, extents.y, extents.z, 1e-6f});
+		const double maxError = targetError * scale * (targetError * scale);
+
+		double resultError = 0.0;
+
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<uint8_t> touched(vertexCount);
+		std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+		std::vector<uint32_t> vertexTriangles;
+
+		// Each pass collapses a set of edges that don't share any triangles, then rebuilds the index buffer
+		while (indices.size() / 3 > targetTriangleCount)
+		{
+			collapses.clear();
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				for (uint32_t e = 0; e < 3; e++)
+				{
+					const uint32_t a = indices[i + e];
+					const uint32_t b = indices[i + (e + 1) % 3];
+
+					for (const auto [from, to] : {std::pair{a, b}, std::pair{b, a}})
+					{
+						if (locked[from])
+						{
+							continue;
+						}
+
+						const Quadric& fromQuadric = quadrics[from];
+						const Quadric& toQuadric = quadrics[positionOf[to]];
+
+						const glm::dvec3 target = position(to);
+						const double error = (fromQuadric.Evaluate(target) + toQuadric.Evaluate(target)) /
+							std::max(fromQuadric.Weight + toQuadric.Weight, 1e-12);
+						collapses.push_back({from, to, error});
+					}
+				}
+			}
+
+			std::ranges::sort(collapses, std::less{}, &Collapse::Error);
+
+			// Triangles around each vertex
+			std::ranges::fill(triangleOffsets, 0);
+			for (const uint32_t index : indices)
+			{
+				triangleOffsets[index + 1]++;
+			}
+			std::inclusive_scan(triangleOffsets.begin(), triangleOffsets.end(), triangleOffsets.begin());
+
+			vertexTriangles.resize(indices.size());
+			{
+				std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+				for (size_t i = 0; i < indices.size(); i++)
+				{
+					vertexTriangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			std::iota(remap.begin(), remap.end(), 0u);
+			std::ranges::fill(touched, 0);
+
+			size_t triangleCount = indices.size() / 3;
+			uint32_t collapsedCount = 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.Error > maxError || triangleCount <= targetTriangleCount)
+				{
+					break;
+				}
+
+				const std::span fromTriangles(vertexTriangles.data() + triangleOffsets[collapse.From],
+				                              triangleOffsets[collapse.From + 1] - triangleOffsets[collapse.From]);
+
+				// Skip collapses next to one made in this pass, their errors and flip checks are out of date
+				bool valid = true;
+				uint32_t removedTriangles = 0;
+
+				for (const uint32_t triangle : fromTriangles)
+				{
+					const uint32_t* corners = &indices[triangle * 3];
+
+					bool containsTarget = false;
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						valid &= !touched[positionOf[corners[c]]];
+						containsTarget |= positionOf[corners[c]] == positionOf[collapse.To];
+					}
+
+					if (containsTarget)
+					{
+						removedTriangles++;
+						continue;
+					}
+
+					// Moving the vertex must not turn any remaining triangle over
+					glm::dvec3 p[3], moved[3];
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						p[c] = position(corners[c]);
+						moved[c] = corners[c] == collapse.From ? position(collapse.To) : p[c];
+					}
+
+					const glm::dvec3 before = cross(p[1] - p[0], p[2] - p[0]);
+					const glm::dvec3 after = cross(moved[1] - moved[0], moved[2] - moved[0]);
+					valid &= dot(before, after) > 0.0;
+				}
+
+				if (!valid)
+				{
+					continue;
+				}
+
+				for (const uint32_t triangle : fromTriangles)
+				{
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						touched[positionOf[indices[triangle * 3 + c]]] = 1;
+					}
+				}
+
+				remap[collapse.From] = collapse.To;
+				quadrics[positionOf[collapse.To]].Add(quadrics[collapse.From]);
+
+				resultError = std::max(resultError, collapse.Error);
+				triangleCount -= removedTriangles;
+				collapsedCount++;
+			}
+
+			if (collapsedCount == 0)
+			{
+				break;
+			}
+
+			// Drop the triangles that collapsed into lines
+			size_t write = 0;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const uint32_t a = remap[indices[i]];
+				const uint32_t b = remap[indices[i + 1]];
+				const uint32_t c = remap[indices[i + 2]];
+
+				if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] || positionOf[c] == positionOf[a])
+				{
+					continue;
+				}
+
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+			indices.resize(write);
+		}
+
+		// Keep only the vertices still referenced, in order of first use
+		SimplifiedMesh result;
+		result.Error = static_cast<float>(std::sqrt(resultError) / scale);
+
+		std::ranges::fill(remap, ~0u);
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == ~0u)
+			{
+				remap[index] = static_cast<uint32_t>(result.Vertices.size());
+				result.Vertices.push_back(vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		result.Indices = std::move(indices);
+		return result;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include "Mesh.hpp"
+
+namespace Snowstorm
+{
+	struct SimplifiedMesh
+	{
+		std::vector<Vertex> Vertices; // Only the vertices the indices still reference
+		std::vector<uint32_t> Indices;
+		float Error = 0.0f; // Largest distance to the original surface, relative to the mesh's largest extent
+	};
+
+	// Reduces the triangle count towards targetRatio with quadric error metric edge collapses
+	// Vertices only ever collapse onto their neighbours, so no new attributes are made up. Vertices on borders and
+	// on normal or texture coordinate seams stay in place to keep silhouettes and charts intact. Stops early rather
+	// than exceeding targetError, which is relative to the mesh's largest extent like SimplifiedMesh::Error.
+	SimplifiedMesh SimplifyMesh(const Mesh& mesh, float targetRatio, float targetError);
+}
@@ -0,0 +1,349 @@
+#include "pch.h"
+#include "OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SS_OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+#include "Snowstorm/Core/JobSystem.hpp"
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Rows of the depth buffer rasterized per job, every job owns its rows so no writes are shared
+		constexpr uint32_t RowsPerJob = 16;
+
+		// Boxes tested per job
+		constexpr uint32_t BoundsPerJob = 1024;
+
+		// Vertices closer to the camera plane than this are treated as behind it
+		constexpr float MinClipW = 1e-5f;
+
+		static_assert(OcclusionCuller::Width % 4 == 0, "Rows are rasterized four pixels at a time");
+
+		glm::vec3 EdgeFunction(const glm::vec4& a, const glm::vec4& b)
+		{
+			return {a.y - b.y, b.x - a.x, (b.y - a.y) * a.x - (b.x - a.x) * a.y};
+		}
+	}
+
+	void OcclusionCuller::BeginFrame(const glm::mat4& viewProjection)
+	{
+		m_ViewProjection = viewProjection;
+		m_Occluders.clear();
+	}
+
+	void OcclusionCuller::AddOccluder(const Ref<Mesh>& mesh, const glm::mat4& transform)
+	{
+		m_Occluders.push_back({mesh, transform});
+	}
+
+	void OcclusionCuller::Rasterize()
+	{
+		SS_PROFILE_FUNCTION();
+
+		SetupTriangles();
+
+		Level& depth = m_Levels.front();
+		depth.Width = Width;
+		depth.Height = Height;
+		depth.Depth.resize(static_cast<size_t>(Width) * Height);
+
+		JobSystem::ParallelFor(Height, RowsPerJob, [this](const uint32_t begin, const uint32_t end)
+		{
+			RasterizeBand(begin, end);
+		});
+
+		BuildHierarchy();
+	}
+
+	void OcclusionCuller::SetupTriangles()
+	{
+		uint32_t vertexCount = 0;
+		uint32_t triangleCount = 0;
+		for (Occluder& occluder : m_Occluders)
+		{
+			occluder.FirstVertex = vertexCount;
+			occluder.FirstTriangle = triangleCount;
+			vertexCount += occluder.Geometry->GetVertexCount();
+			triangleCount += occluder.Geometry->GetIndexCount() / 3;
+		}
+
+		m_ScreenVertices.resize(vertexCount);
+		m_Triangles.resize(triangleCount);
+		m_TriangleValid.resize(triangleCount);
+
+		const auto occluderCount = static_cast<uint32_t>(m_Occluders.size());
+		JobSystem::ParallelFor(occluderCount, 1, [&](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t o = begin; o < end; o++)
+			{
+				const Occluder& occluder = m_Occluders[o];
+				const glm::mat4 transform = m_ViewProjection * occluder.Transform;
+
+				glm::vec4* screen = &m_ScreenVertices[occluder.FirstVertex];
+				for (const Vertex& vertex : occluder.Geometry->GetVertices())
+				{
+					// In front of the camera but closer than the near plane counts as well, the depth would be below -1
+					const glm::vec4 clip = transform * glm::vec4{vertex.Position, 1.0f};
+					if (clip.w < MinClipW || clip.z < -clip.w)
+					{
+						*screen++ = glm::vec4{0.0f};
+						continue;
+					}
+
+					const glm::vec3 ndc = glm::vec3{clip} / clip.w;
+					*screen++ = {(ndc.x * 0.5f + 0.5f) * Width, (ndc.y * 0.5f + 0.5f) * Height, ndc.z, 1.0f};
+				}
+
+				const std::vector<uint32_t>& indices = occluder.Geometry->GetIndices();
+				for (uint32_t t = 0; t < indices.size() / 3; t++)
+				{
+					const uint32_t index = occluder.FirstTriangle + t;
+					m_TriangleValid[index] = 0;
+
+					glm::vec4 v0 = m_ScreenVertices[occluder.FirstVertex + indices[t * 3 + 0]];
+					glm::vec4 v1 = m_ScreenVertices[occluder.FirstVertex + indices[t * 3 + 1]];
+					glm::vec4 v2 = m_ScreenVertices[occluder.FirstVertex + indices[t * 3 + 2]];
+					if (v0.w == 0.0f || v1.w == 0.0f || v2.w == 0.0f)
+					{
+						continue;
+					}
+
+					// Both windings are drawn, so open occluders like walls hide things from either side
+					float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+					if (area < 0.0f)
+					{
+						std::swap(v1, v2);
+						area = -area;
+					}
+
+					const float minX = std::max(std::floor(std::min({v0.x, v1.x, v2.x})), 0.0f);
+					const float maxX = std::min(std::ceil(std::max({v0.x, v1.x, v2.x})), Width - 1.0f);
+					const float minY = std::max(std::floor(std::min({v0.y, v1.y, v2.y})), 0.0f);
+					const float maxY = std::min(std::ceil(std::max({v0.y, v1.y, v2.y})), Height - 1.0f);
+					if (area < 1e-6f || minX > maxX || minY > maxY)
+					{
+						continue;
+					}
+
+					Triangle& triangle = m_Triangles[index];
+					triangle.EdgeA = EdgeFunction(v1, v2); // Weight of v0
+					triangle.EdgeB = EdgeFunction(v2, v0);
+					triangle.EdgeC = EdgeFunction(v0, v1);
+					const glm::vec3 depthPlane = triangle.EdgeA * v0.z + triangle.EdgeB * v1.z + triangle.EdgeC * v2.z;
+					triangle.DepthPlane = depthPlane / area;
+					triangle.MinX = static_cast<int32_t>(minX);
+					triangle.MaxX = static_cast<int32_t>(maxX);
+					triangle.MinY = static_cast<int32_t>(minY);
+					triangle.MaxY = static_cast<int32_t>(maxY);
+
+					m_TriangleValid[index] = 1;
+				}
+			}
+		});
+	}
+
+	void OcclusionCuller::RasterizeBand(const uint32_t beginRow, const uint32_t endRow)
+	{
+		float* depth = m_Levels.front().Depth.data();
+		std::fill(depth + beginRow * Width, depth + endRow * Width, 1.0f);
+
+		for (uint32_t t = 0; t < m_Triangles.size(); t++)
+		{
+			const Triangle& triangle = m_Triangles[t];
+			if (!m_TriangleValid[t] || triangle.MaxY < static_cast<int32_t>(beginRow) ||
+				triangle.MinY >= static_cast<int32_t>(endRow))
+			{
+				continue;
+			}
+
+			const int32_t firstRow = std::max(triangle.MinY, static_cast<int32_t>(beginRow));
+			const int32_t lastRow = std::min(triangle.MaxY, static_cast<int32_t>(endRow) - 1);
+
+			for (int32_t y = firstRow; y <= lastRow; y++)
+			{
+				const float py = static_cast<float>(y) + 0.5f;
+				const float rowA = triangle.EdgeA.y * py + triangle.EdgeA.z;
+				const float rowB = triangle.EdgeB.y * py + triangle.EdgeB.z;
+				const float rowC = triangle.EdgeC.y * py + triangle.EdgeC.z;
+				const float rowDepth = triangle.DepthPlane.y * py + triangle.DepthPlane.z;
+
+				float* row = depth + y * Width;
+				int32_t x = triangle.MinX;
+
+#ifdef SS_OCCLUSION_SSE
+				// Four pixels per step, starting at the aligned block so the last one never passes the row's end
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 stepA = _mm_set1_ps(triangle.EdgeA.x);
+				const __m128 stepB = _mm_set1_ps(triangle.EdgeB.x);
+				const __m128 stepC = _mm_set1_ps(triangle.EdgeC.x);
+				const __m128 stepDepth = _mm_set1_ps(triangle.DepthPlane.x);
+
+				for (x &= ~3; x <= triangle.MaxX; x += 4)
+				{
+					const float px = static_cast<float>(x) + 0.5f;
+					const __m128 xs = _mm_add_ps(_mm_set1_ps(px), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+
+					const __m128 a = _mm_add_ps(_mm_mul_ps(stepA, xs), _mm_set1_ps(rowA));
+					const __m128 b = _mm_add_ps(_mm_mul_ps(stepB, xs), _mm_set1_ps(rowB));
+					const __m128 c = _mm_add_ps(_mm_mul_ps(stepC, xs), _mm_set1_ps(rowC));
+					const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(a, zero), _mm_cmpge_ps(b, zero)),
+					                                 _mm_cmpge_ps(c, zero));
+					if (_mm_movemask_ps(inside) == 0)
+					{
+						continue;
+					}
+
+					const __m128 current = _mm_loadu_ps(row + x);
+					const __m128 nearest = _mm_min_ps(current, _mm_add_ps(_mm_mul_ps(stepDepth, xs),
+					                                                      _mm_set1_ps(rowDepth)));
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+				}
+#endif
+
+				for (; x <= triangle.MaxX; x++)
+				{
+					const float px = static_cast<float>(x) + 0.5f;
+					if (triangle.EdgeA.x * px + rowA >= 0.0f && triangle.EdgeB.x * px + rowB >= 0.0f &&
+						triangle.EdgeC.x * px + rowC >= 0.0f)
+					{
+						row[x] = std::min(row[x], triangle.DepthPlane.x * px + rowDepth);
+					}
+				}
+			}
+		}
+	}
+
+	void OcclusionCuller::BuildHierarchy()
+	{
+		SS_PROFILE_FUNCTION();
+
+		uint32_t levelCount = 1;
+		for (uint32_t w = Width, h = Height; w > 1 || h > 1; w = std::max(w / 2, 1u), h = std::max(h / 2, 1u))
+		{
+			levelCount++;
+		}
+		m_Levels.resize(levelCount);
+
+		for (uint32_t i = 1; i < levelCount; i++)
+		{
+			const Level& source = m_Levels[i - 1];
+			Level& level = m_Levels[i];
+			level.Width = std::max(source.Width / 2, 1u);
+			level.Height = std::max(source.Height / 2, 1u);
+			level.Depth.resize(static_cast<size_t>(level.Width) * level.Height);
+
+			for (uint32_t y = 0; y < level.Height; y++)
+			{
+				const uint32_t y0 = y * 2;
+				const uint32_t y1 = std::min(y0 + 1, source.Height - 1);
+
+				for (uint32_t x = 0; x < level.Width; x++)
+				{
+					const uint32_t x0 = x * 2;
+					const uint32_t x1 = std::min(x0 + 1, source.Width - 1);
+
+					level.Depth[y * level.Width + x] = std::max(
+						std::max(source.Depth[y0 * source.Width + x0], source.Depth[y0 * source.Width + x1]),
+						std::max(source.Depth[y1 * source.Width + x0], source.Depth[y1 * source.Width + x1]));
+				}
+			}
+		}
+	}
+
+	bool OcclusionCuller::IsOccluded(const AABB& bounds) const
+	{
+		if (m_Occluders.empty())
+		{
+			return false;
+		}
+
+		glm::vec2 screenMin{std::numeric_limits<float>::max()};
+		glm::vec2 screenMax{std::numeric_limits<float>::lowest()};
+		float nearestDepth = std::numeric_limits<float>::max();
+
+		for (uint32_t corner = 0; corner < 8; corner++)
+		{
+			const glm::vec3 position{
+				corner & 1 ? bounds.Max.x : bounds.Min.x,
+				corner & 2 ? bounds.Max.y : bounds.Min.y,
+				corner & 4 ? bounds.Max.z : bounds.Min.z
+			};
+
+			// Boxes reaching behind the camera cover the whole view
+			const glm::vec4 clip = m_ViewProjection * glm::vec4{position, 1.0f};
+			if (clip.w < MinClipW)
+			{
+				return false;
+			}
+
+			const glm::vec3 ndc = glm::vec3{clip} / clip.w;
+			screenMin = min(screenMin, glm::vec2{ndc});
+			screenMax = max(screenMax, glm::vec2{ndc});
+			nearestDepth = std::min(nearestDepth, ndc.z);
+		}
+
+		screenMin = (screenMin * 0.5f + 0.5f) * glm::vec2{Width, Height};
+		screenMax = (screenMax * 0.5f + 0.5f) * glm::vec2{Width, Height};
+		if (screenMax.x < 0.0f || screenMax.y < 0.0f || screenMin.x >= Width || screenMin.y >= Height)
+		{
+			return false; // Off screen, that's for frustum culling to decide
+		}
+
+		// Every pixel the rectangle touches, looked up in the level where it spans a few texels
+		const auto minX = static_cast<uint32_t>(std::max(screenMin.x, 0.0f));
+		const auto minY = static_cast<uint32_t>(std::max(screenMin.y, 0.0f));
+		const auto maxX = static_cast<uint32_t>(std::min(screenMax.x, Width - 1.0f));
+		const auto maxY = static_cast<uint32_t>(std::min(screenMax.y, Height - 1.0f));
+
+		const uint32_t size = std::max(maxX - minX, maxY - minY) + 1;
+		const int sizeLevel = std::max(static_cast<int>(std::bit_width(size)) - 2, 0);
+		const uint32_t levelIndex = std::min(static_cast<uint32_t>(sizeLevel),
+		                                     static_cast<uint32_t>(m_Levels.size()) - 1);
+		const Level& level = m_Levels[levelIndex];
+
+		for (uint32_t y = minY >> levelIndex; y <= maxY >> levelIndex; y++)
+		{
+			for (uint32_t x = minX >> levelIndex; x <= maxX >> levelIndex; x++)
+			{
+				if (level.Depth[y * level.Width + x] >= nearestDepth)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	uint32_t OcclusionCuller::Cull(const PackedBounds& bounds, std::vector<uint8_t>& visible) const
+	{
+		SS_PROFILE_FUNCTION();
+
+		std::atomic<uint32_t> occludedCount = 0;
+		JobSystem::ParallelFor(bounds.GetCount(), BoundsPerJob, [&](const uint32_t begin, const uint32_t end)
+		{
+			uint32_t jobOccludedCount = 0;
+			for (uint32_t i = begin; i < end; i++)
+			{
+				if (visible[i] && IsOccluded(bounds.Get(i)))
+				{
+					visible[i] = 0;
+					jobOccludedCount++;
+				}
+			}
+
+			occludedCount.fetch_add(jobOccludedCount, std::memory_order_relaxed);
+		});
+
+		return occludedCount.load(std::memory_order_relaxed);
+	}
+}
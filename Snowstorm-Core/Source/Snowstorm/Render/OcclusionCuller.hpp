@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Bounds.hpp"
+#include "Mesh.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// Hides meshes behind designated occluders using a small depth buffer rasterized on the CPU
+	// Occluders are drawn in horizontal bands on the job system, then a hierarchy keeping the farthest depth of every
+	// 2x2 block lets a box be rejected in a handful of lookups. Coverage is sampled at pixel centers and triangles
+	// crossing the near plane are skipped, so nothing is hidden unless the occluders in front of it were drawn.
+	class OcclusionCuller final : public NonCopyable
+	{
+	public:
+		static constexpr uint32_t Width = 256;
+		static constexpr uint32_t Height = 128;
+
+		// Drops the occluders of the previous view, depth is normalized device z
+		void BeginFrame(const glm::mat4& viewProjection);
+
+		// The mesh has to stay alive until Rasterize, a coarse level of detail is usually enough
+		void AddOccluder(const Ref<Mesh>& mesh, const glm::mat4& transform);
+
+		// Draws the occluders added since BeginFrame and builds the hierarchy
+		void Rasterize();
+
+		[[nodiscard]] bool HasOccluders() const { return !m_Occluders.empty(); }
+
+		[[nodiscard]] bool IsOccluded(const AABB& bounds) const;
+
+		// Clears visible[i] of every visible box that is occluded, on the job system. Returns the number cleared.
+		uint32_t Cull(const PackedBounds& bounds, std::vector<uint8_t>& visible) const;
+
+		// Nearest occluder depth per pixel, rows bottom to top, 1 where nothing was drawn
+		[[nodiscard]] const std::vector<float>& GetDepth() const { return m_Levels.front().Depth; }
+
+		[[nodiscard]] uint32_t GetOccluderTriangleCount() const { return static_cast<uint32_t>(m_Triangles.size()); }
+
+	private:
+		struct Occluder
+		{
+			Ref<Mesh> Geometry;
+			glm::mat4 Transform;
+			uint32_t FirstVertex = 0;
+			uint32_t FirstTriangle = 0;
+		};
+
+		// Edge functions and depth plane of a triangle in pixel coordinates, all three edges are >= 0 inside it
+		struct Triangle
+		{
+			glm::vec3 EdgeA, EdgeB, EdgeC; // x * EdgeN.x + y * EdgeN.y + EdgeN.z
+			glm::vec3 DepthPlane;
+			int32_t MinX, MaxX, MinY, MaxY; // Inclusive pixel bounds, clamped to the buffer
+		};
+
+		struct Level
+		{
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			std::vector<float> Depth;
+		};
+
+		void SetupTriangles();
+		void RasterizeBand(uint32_t beginRow, uint32_t endRow);
+		void BuildHierarchy();
+
+		glm::mat4 m_ViewProjection{1.0f};
+
+		std::vector<Occluder> m_Occluders;
+		std::vector<glm::vec4> m_ScreenVertices; // Pixel x, pixel y, depth, 0 when behind the near plane
+		std::vector<Triangle> m_Triangles;
+		std::vector<uint8_t> m_TriangleValid;
+
+		std::vector<Level> m_Levels{1}; // Full resolution first, then the farthest depth of every 2x2 block
+	};
+}
@@ -27,14 +27,36 @@ namespace Snowstorm
 			s_RendererAPI->Clear();
 		}
 
-		static void DrawIndexed(const Ref<VertexArray>& vertexArray, const uint32_t count = 0)
+		static void SetDepthFunction(const RendererAPI::DepthFunction function)
 		{
-			s_RendererAPI->DrawIndexed(vertexArray, count);
+			s_RendererAPI->SetDepthFunction(function);
 		}
 
-		static void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, const uint32_t count, const uint32_t instanceCount)
+		static void SetWriteMask(const bool color, const bool depth)
 		{
-			s_RendererAPI->DrawIndexedInstanced(vertexArray, count, instanceCount);
+			s_RendererAPI->SetWriteMask(color, depth);
+		}
+
+		static void DrawIndexed(const Ref<VertexArray>& vertexArray, const uint32_t count = 0, const uint32_t baseVertex = 0)
+		{
+			s_RendererAPI->DrawIndexed(vertexArray, count, baseVertex);
+		}
+
+		static void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, const uint32_t count, const uint32_t instanceCount,
+		                                 const uint32_t baseInstance = 0, const uint32_t baseVertex = 0)
+		{
+			s_RendererAPI->DrawIndexedInstanced(vertexArray, count, instanceCount, baseInstance, baseVertex);
+		}
+
+		static void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands,
+		                                const uint32_t drawCount, const uint32_t offset = 0)
+		{
+			s_RendererAPI->DrawIndexedIndirect(vertexArray, commands, drawCount, offset);
+		}
+
+		static const RendererCapabilities& GetCapabilities()
+		{
+			return s_RendererAPI->GetCapabilities();
 		}
 
 	private:
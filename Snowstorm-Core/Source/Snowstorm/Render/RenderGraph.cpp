@@ -0,0 +1,454 @@
+#include "pch.h"
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <queue>
+#include <sstream>
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Transient framebuffers no graph needed for this many frames are released
+		constexpr uint32_t MaxUnusedFrames = 120;
+
+		bool IsCompatible(const FramebufferSpecification& a, const FramebufferSpecification& b)
+		{
+			return a.Width == b.Width && a.Height == b.Height && a.Samples == b.Samples &&
+				a.SwapChainTarget == b.SwapChainTarget;
+		}
+
+		// RGBA8 color and 24 bit depth with 8 bit stencil
+		uint64_t GetFramebufferBytes(const FramebufferSpecification& spec)
+		{
+			return static_cast<uint64_t>(spec.Width) * spec.Height * spec.Samples * 8;
+		}
+
+		void AddUnique(std::vector<uint32_t>& indices, const uint32_t index)
+		{
+			if (std::ranges::find(indices, index) == indices.end())
+			{
+				indices.push_back(index);
+			}
+		}
+	}
+
+	RenderGraphResource RenderGraphBuilder::CreateFramebuffer(const std::string& name,
+	                                                          const FramebufferSpecification& spec)
+	{
+		auto& resource = m_Graph.m_Resources.emplace_back();
+		resource.Name = name;
+		resource.Specification = spec;
+
+		return {static_cast<uint32_t>(m_Graph.m_Resources.size() - 1)};
+	}
+
+	void RenderGraphBuilder::Read(const RenderGraphResource resource)
+	{
+		SS_CORE_ASSERT(resource.Index < m_Graph.m_Resources.size(), "Invalid render graph resource!");
+
+		AddUnique(m_Graph.m_Passes[m_Pass].Reads, resource.Index);
+		AddUnique(m_Graph.m_Resources[resource.Index].Readers, m_Pass);
+	}
+
+	void RenderGraphBuilder::Write(const RenderGraphResource resource)
+	{
+		SS_CORE_ASSERT(resource.Index < m_Graph.m_Resources.size(), "Invalid render graph resource!");
+
+		AddUnique(m_Graph.m_Passes[m_Pass].Writes, resource.Index);
+		AddUnique(m_Graph.m_Resources[resource.Index].Writers, m_Pass);
+	}
+
+	void RenderGraphBuilder::SetSideEffect()
+	{
+		m_Graph.m_Passes[m_Pass].SideEffect = true;
+	}
+
+	const Ref<Framebuffer>& RenderGraphContext::GetFramebuffer(const RenderGraphResource resource) const
+	{
+		SS_CORE_ASSERT(m_Graph.Uses(m_Pass, resource.Index), "Pass accesses a resource it didn't declare!");
+
+		const auto& graphResource = m_Graph.m_Resources[resource.Index];
+		if (graphResource.Imported)
+		{
+			return graphResource.Imported;
+		}
+
+		return m_Graph.m_TransientFramebuffers[graphResource.Physical].Instance;
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Passes.clear();
+		m_Resources.clear();
+		m_Order.clear();
+		m_Compiled = false;
+
+		// No resource refers to the transient framebuffers now, so they can be released
+		std::erase_if(m_TransientFramebuffers, [](const TransientFramebuffer& framebuffer)
+		{
+			return framebuffer.UnusedFrames > MaxUnusedFrames;
+		});
+	}
+
+	RenderGraphResource RenderGraph::ImportFramebuffer(const std::string& name, Ref<Framebuffer> framebuffer)
+	{
+		auto& resource = m_Resources.emplace_back();
+		resource.Name = name;
+		resource.Specification = framebuffer->GetSpecification();
+		resource.Imported = std::move(framebuffer);
+
+		return {static_cast<uint32_t>(m_Resources.size() - 1)};
+	}
+
+	void RenderGraph::AddPass(const std::string& name, const SetupFunction& setup, ExecuteFunction execute)
+	{
+		auto& pass = m_Passes.emplace_back();
+		pass.Name = name;
+		pass.Execute = std::move(execute);
+
+		RenderGraphBuilder builder(*this, static_cast<uint32_t>(m_Passes.size() - 1));
+		setup(builder);
+
+		m_Compiled = false;
+	}
+
+	bool RenderGraph::Compile()
+	{
+		SS_PROFILE_FUNCTION();
+
+		if (!Validate())
+		{
+			return false;
+		}
+
+		Cull();
+
+		if (!Order())
+		{
+			return false;
+		}
+
+		AssignTransientFramebuffers();
+
+		m_Compiled = true;
+		return true;
+	}
+
+	void RenderGraph::Execute()
+	{
+		SS_PROFILE_FUNCTION();
+
+		SS_CORE_ASSERT(m_Compiled, "Render graph has to be compiled before executing!");
+
+		for (const uint32_t passIndex : m_Order)
+		{
+			Pass& pass = m_Passes[passIndex];
+
+			const auto start = std::chrono::steady_clock::now();
+			pass.Execute(RenderGraphContext(*this, passIndex));
+			pass.CPUTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+	}
+
+	bool RenderGraph::Uses(const uint32_t pass, const uint32_t resource) const
+	{
+		return std::ranges::find(m_Passes[pass].Reads, resource) != m_Passes[pass].Reads.end() ||
+			std::ranges::find(m_Passes[pass].Writes, resource) != m_Passes[pass].Writes.end();
+	}
+
+	bool RenderGraph::Validate() const
+	{
+		bool valid = true;
+
+		for (const Resource& resource : m_Resources)
+		{
+			if (!resource.Imported && resource.Writers.empty() && !resource.Readers.empty())
+			{
+				SS_CORE_ERROR("Render graph: '{0}' is read by '{1}' but no pass writes it", resource.Name,
+				              m_Passes[resource.Readers.front()].Name);
+				valid = false;
+			}
+
+			if (!resource.Imported && (resource.Specification.Width == 0 || resource.Specification.Height == 0))
+			{
+				SS_CORE_ERROR("Render graph: '{0}' has no size", resource.Name);
+				valid = false;
+			}
+		}
+
+		return valid;
+	}
+
+	void RenderGraph::Cull()
+	{
+		// Passes producing outputs are needed, and so is every writer whose results they see
+		std::vector<uint32_t> stack;
+		for (uint32_t i = 0; i < m_Passes.size(); i++)
+		{
+			Pass& pass = m_Passes[i];
+			pass.Culled = !pass.SideEffect && std::ranges::none_of(pass.Writes, [&](const uint32_t resource)
+			{
+				return m_Resources[resource].Imported != nullptr;
+			});
+
+			if (!pass.Culled)
+			{
+				stack.push_back(i);
+			}
+		}
+
+		const auto keep = [&](const uint32_t writer)
+		{
+			if (m_Passes[writer].Culled)
+			{
+				m_Passes[writer].Culled = false;
+				stack.push_back(writer);
+			}
+		};
+
+		while (!stack.empty())
+		{
+			const uint32_t passIndex = stack.back();
+			stack.pop_back();
+
+			// Reads see every write, writes build on the ones declared before them
+			for (const uint32_t resource : m_Passes[passIndex].Reads)
+			{
+				std::ranges::for_each(m_Resources[resource].Writers, keep);
+			}
+
+			for (const uint32_t resource : m_Passes[passIndex].Writes)
+			{
+				for (const uint32_t writer : m_Resources[resource].Writers)
+				{
+					if (writer < passIndex)
+					{
+						keep(writer);
+					}
+				}
+			}
+		}
+	}
+
+	bool RenderGraph::Order()
+	{
+		// Writers of a resource run in declaration order, and passes that only read it run after all of them
+		std::vector<std::vector<uint32_t>> successors(m_Passes.size());
+		std::vector<uint32_t> dependencyCounts(m_Passes.size(), 0);
+
+		const auto addDependency = [&](const uint32_t from, const uint32_t to)
+		{
+			successors[from].push_back(to);
+			dependencyCounts[to]++;
+		};
+
+		for (uint32_t resourceIndex = 0; resourceIndex < m_Resources.size(); resourceIndex++)
+		{
+			const Resource& resource = m_Resources[resourceIndex];
+
+			uint32_t lastWriter = RenderGraphResource::Invalid;
+			for (const uint32_t writer : resource.Writers)
+			{
+				if (m_Passes[writer].Culled)
+				{
+					continue;
+				}
+
+				if (lastWriter != RenderGraphResource::Invalid)
+				{
+					addDependency(lastWriter, writer);
+				}
+				lastWriter = writer;
+			}
+
+			if (lastWriter == RenderGraphResource::Invalid)
+			{
+				continue;
+			}
+
+			for (const uint32_t reader : resource.Readers)
+			{
+				if (!m_Passes[reader].Culled && std::ranges::find(resource.Writers, reader) == resource.Writers.end())
+				{
+					addDependency(lastWriter, reader);
+				}
+			}
+		}
+
+		// Among passes that are ready, the one declared first runs first
+		std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> ready;
+		uint32_t liveCount = 0;
+		for (uint32_t i = 0; i < m_Passes.size(); i++)
+		{
+			if (!m_Passes[i].Culled)
+			{
+				liveCount++;
+				if (dependencyCounts[i] == 0)
+				{
+					ready.push(i);
+				}
+			}
+		}
+
+		m_Order.clear();
+		while (!ready.empty())
+		{
+			const uint32_t passIndex = ready.top();
+			ready.pop();
+			m_Order.push_back(passIndex);
+
+			for (const uint32_t successor : successors[passIndex])
+			{
+				if (--dependencyCounts[successor] == 0)
+				{
+					ready.push(successor);
+				}
+			}
+		}
+
+		if (m_Order.size() != liveCount)
+		{
+			for (uint32_t i = 0; i < m_Passes.size(); i++)
+			{
+				if (!m_Passes[i].Culled && dependencyCounts[i] > 0)
+				{
+					SS_CORE_ERROR("Render graph: pass '{0}' is part of a dependency cycle", m_Passes[i].Name);
+				}
+			}
+
+			return false;
+		}
+
+		return true;
+	}
+
+	void RenderGraph::AssignTransientFramebuffers()
+	{
+		for (TransientFramebuffer& framebuffer : m_TransientFramebuffers)
+		{
+			framebuffer.Assigned = false;
+		}
+
+		// Lifetimes as positions in the execution order
+		std::vector<uint32_t> transients;
+		for (uint32_t position = 0; position < m_Order.size(); position++)
+		{
+			const Pass& pass = m_Passes[m_Order[position]];
+
+			for (const auto* accesses : {&pass.Reads, &pass.Writes})
+			{
+				for (const uint32_t resourceIndex : *accesses)
+				{
+					Resource& resource = m_Resources[resourceIndex];
+					if (resource.Imported)
+					{
+						continue;
+					}
+
+					if (resource.Physical == RenderGraphResource::Invalid)
+					{
+						resource.Physical = 0; // Marks the resource as seen, assigned below
+						resource.FirstUse = position;
+						transients.push_back(resourceIndex);
+					}
+
+					resource.LastUse = position;
+				}
+			}
+		}
+
+		// transients is ordered by first use, so each framebuffer goes to the next resource once its last one is done
+		for (const uint32_t resourceIndex : transients)
+		{
+			Resource& resource = m_Resources[resourceIndex];
+
+			auto it = std::ranges::find_if(m_TransientFramebuffers, [&](const TransientFramebuffer& framebuffer)
+			{
+				return (!framebuffer.Assigned || framebuffer.BusyUntil < resource.FirstUse) &&
+					IsCompatible(framebuffer.Instance->GetSpecification(), resource.Specification);
+			});
+
+			if (it == m_TransientFramebuffers.end())
+			{
+				m_TransientFramebuffers.push_back({Framebuffer::Create(resource.Specification)});
+				it = std::prev(m_TransientFramebuffers.end());
+			}
+
+			it->Assigned = true;
+			it->BusyUntil = resource.LastUse;
+			resource.Physical = static_cast<uint32_t>(it - m_TransientFramebuffers.begin());
+		}
+
+		for (TransientFramebuffer& framebuffer : m_TransientFramebuffers)
+		{
+			framebuffer.UnusedFrames = framebuffer.Assigned ? 0 : framebuffer.UnusedFrames + 1;
+		}
+	}
+
+	std::string RenderGraph::Dump() const
+	{
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3);
+
+		out << "Render graph: " << m_Order.size() << " of " << m_Passes.size() << " passes executed\n";
+
+		float totalTime = 0.0f;
+		for (uint32_t position = 0; position < m_Order.size(); position++)
+		{
+			const Pass& pass = m_Passes[m_Order[position]];
+			totalTime += pass.CPUTime;
+
+			out << "  " << position << ". " << pass.Name << " (" << pass.CPUTime << " ms)";
+			for (const uint32_t resource : pass.Reads)
+			{
+				out << " reads '" << m_Resources[resource].Name << "'";
+			}
+			for (const uint32_t resource : pass.Writes)
+			{
+				out << " writes '" << m_Resources[resource].Name << "'";
+			}
+			out << "\n";
+		}
+		out << "  Total: " << totalTime << " ms\n";
+
+		for (const Pass& pass : m_Passes)
+		{
+			if (pass.Culled)
+			{
+				out << "  Culled: " << pass.Name << "\n";
+			}
+		}
+
+		uint64_t requestedBytes = 0;
+		uint32_t transientCount = 0;
+		for (const Resource& resource : m_Resources)
+		{
+			if (resource.Imported || resource.Physical == RenderGraphResource::Invalid)
+			{
+				continue;
+			}
+
+			transientCount++;
+			requestedBytes += GetFramebufferBytes(resource.Specification);
+
+			out << "  '" << resource.Name << "' " << resource.Specification.Width << "x" << resource.Specification.Height
+				<< " in framebuffer " << resource.Physical << " during passes " << resource.FirstUse << "-"
+				<< resource.LastUse << "\n";
+		}
+
+		uint64_t allocatedBytes = 0;
+		for (const TransientFramebuffer& framebuffer : m_TransientFramebuffers)
+		{
+			allocatedBytes += GetFramebufferBytes(framebuffer.Instance->GetSpecification());
+		}
+
+		out << "  " << transientCount << " transient framebuffers in " << m_TransientFramebuffers.size() << " ("
+			<< static_cast<double>(allocatedBytes) / (1024.0 * 1024.0) << " MB, "
+			<< static_cast<double>(requestedBytes) / (1024.0 * 1024.0) << " MB without aliasing)";
+
+		return out.str();
+	}
+}
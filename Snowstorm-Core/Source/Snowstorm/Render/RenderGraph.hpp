@@ -0,0 +1,147 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Framebuffer.hpp"
+
+#include "Snowstorm/Core/Base.h"
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// Framebuffer of a RenderGraph, valid until the graph is reset
+	struct RenderGraphResource
+	{
+		static constexpr uint32_t Invalid = ~0u;
+
+		uint32_t Index = Invalid;
+
+		[[nodiscard]] bool IsValid() const { return Index != Invalid; }
+	};
+
+	class RenderGraph;
+
+	// Declares the resources of the pass being added
+	class RenderGraphBuilder
+	{
+	public:
+		// Framebuffer that only exists while passes use it, its contents are undefined until written
+		RenderGraphResource CreateFramebuffer(const std::string& name, const FramebufferSpecification& spec);
+
+		void Read(RenderGraphResource resource);
+		// Writes keep what earlier writers left, so several passes can draw into one framebuffer in order
+		void Write(RenderGraphResource resource);
+
+		// Keeps the pass even if nothing reads what it writes, e.g. to present
+		void SetSideEffect();
+
+	private:
+		RenderGraphBuilder(RenderGraph& graph, const uint32_t pass)
+			: m_Graph(graph), m_Pass(pass)
+		{
+		}
+
+		RenderGraph& m_Graph;
+		uint32_t m_Pass;
+
+		friend class RenderGraph;
+	};
+
+	// Resolves resources to framebuffers while a pass executes
+	class RenderGraphContext
+	{
+	public:
+		// Only resources the pass declared can be accessed
+		[[nodiscard]] const Ref<Framebuffer>& GetFramebuffer(RenderGraphResource resource) const;
+
+	private:
+		RenderGraphContext(const RenderGraph& graph, const uint32_t pass)
+			: m_Graph(graph), m_Pass(pass)
+		{
+		}
+
+		const RenderGraph& m_Graph;
+		uint32_t m_Pass;
+
+		friend class RenderGraph;
+	};
+
+	// Frame described as passes and the framebuffers they read and write
+	// Compiling culls passes whose results are never used, orders the rest by their dependencies and places transient
+	// framebuffers whose lifetimes don't overlap in the same physical framebuffer. Imported framebuffers are the
+	// graph's outputs. Only uses the Framebuffer abstraction, so it works on every backend. Render thread only.
+	class RenderGraph final : public NonCopyable
+	{
+	public:
+		using SetupFunction = std::function<void(RenderGraphBuilder&)>;
+		using ExecuteFunction = std::function<void(const RenderGraphContext&)>;
+
+		// Removes all passes and resources, transient framebuffers are kept for the next frame's graph
+		void Reset();
+
+		RenderGraphResource ImportFramebuffer(const std::string& name, Ref<Framebuffer> framebuffer);
+
+		// setup runs immediately, execute once the graph executes
+		void AddPass(const std::string& name, const SetupFunction& setup, ExecuteFunction execute);
+
+		// Logs every problem found and returns false if the graph can't execute
+		bool Compile();
+		void Execute();
+
+		// Execution order, culled passes, transient framebuffer aliasing and the CPU time of each pass
+		[[nodiscard]] std::string Dump() const;
+
+	private:
+		struct Resource
+		{
+			std::string Name;
+			FramebufferSpecification Specification;
+			Ref<Framebuffer> Imported; // Null for transient framebuffers
+
+			std::vector<uint32_t> Writers; // Passes in declaration order
+			std::vector<uint32_t> Readers;
+
+			uint32_t FirstUse = 0; // Positions in the execution order
+			uint32_t LastUse = 0;
+			uint32_t Physical = RenderGraphResource::Invalid; // Index into m_TransientFramebuffers
+		};
+
+		struct Pass
+		{
+			std::string Name;
+			ExecuteFunction Execute;
+			std::vector<uint32_t> Reads;
+			std::vector<uint32_t> Writes;
+			bool SideEffect = false;
+			bool Culled = false;
+			float CPUTime = 0.0f; // Milliseconds, of the last execution
+		};
+
+		struct TransientFramebuffer
+		{
+			Ref<Framebuffer> Instance;
+			uint32_t BusyUntil = 0; // Last position in the execution order using it
+			bool Assigned = false;
+			uint32_t UnusedFrames = 0;
+		};
+
+		[[nodiscard]] bool Uses(uint32_t pass, uint32_t resource) const;
+
+		bool Validate() const;
+		void Cull();
+		bool Order();
+		void AssignTransientFramebuffers();
+
+		std::vector<Pass> m_Passes;
+		std::vector<Resource> m_Resources;
+		std::vector<uint32_t> m_Order; // Passes left after culling, in execution order
+		bool m_Compiled = false;
+
+		std::vector<TransientFramebuffer> m_TransientFramebuffers;
+
+		friend class RenderGraphBuilder;
+		friend class RenderGraphContext;
+	};
+}
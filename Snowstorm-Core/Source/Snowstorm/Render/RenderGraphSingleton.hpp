@@ -0,0 +1,25 @@
+#pragma once
+
+#include <utility>
+
+#include "RenderGraph.hpp"
+
+#include "Snowstorm/ECS/Singleton.hpp"
+
+namespace Snowstorm
+{
+	// Keeps the render graph, and with it the transient framebuffers, across frames
+	class RenderGraphSingleton final : public Singleton
+	{
+	public:
+		RenderGraph& GetGraph() { return m_Graph; }
+
+		// Logs the graph of the next frame once it executed
+		void RequestDump() { m_DumpRequested = true; }
+		bool ConsumeDumpRequest() { return std::exchange(m_DumpRequested, false); }
+
+	private:
+		RenderGraph m_Graph;
+		bool m_DumpRequested = false;
+	};
+}
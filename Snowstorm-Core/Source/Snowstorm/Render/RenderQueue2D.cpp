@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "RenderQueue2D.hpp"
+
+#include <numeric>
+
+#include "Renderer2D.hpp"
+
+#include "Snowstorm/Core/JobSystem.hpp"
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Sprites handled per job while building keys and gathering sorted data
+		constexpr uint32_t SpritesPerJob = 4096;
+
+		// Key layout, from the most significant bit:
+		//   opaque:      layer (8) | 0 | texture (23) | depth front to back (32)
+		//   translucent: layer (8) | 1 | depth back to front (32) | texture (23)
+		constexpr uint32_t LayerShift = 56;
+		constexpr uint32_t TranslucentShift = 55;
+		constexpr uint64_t TextureMask = (1ull << 23) - 1;
+	}
+
+	void RenderQueue2D::Resize(const uint32_t spriteCount)
+	{
+		m_Transforms.resize(spriteCount);
+		m_Colors.resize(spriteCount);
+		m_Textures.resize(spriteCount);
+		m_UVRects.resize(spriteCount);
+		m_TilingFactors.resize(spriteCount);
+		m_Layers.resize(spriteCount);
+
+		m_VisibleSprites.resize(spriteCount);
+		std::iota(m_VisibleSprites.begin(), m_VisibleSprites.end(), 0);
+	}
+
+	void RenderQueue2D::SetSprite(const uint32_t index, const glm::mat4& transform, const glm::vec4& color,
+	                              const Ref<Texture2D>& texture, const glm::vec4& uvRect, const float tilingFactor,
+	                              const uint8_t layer)
+	{
+		m_Transforms[index] = transform;
+		m_Colors[index] = color;
+		m_Textures[index] = texture;
+		m_UVRects[index] = uvRect;
+		m_TilingFactors[index] = tilingFactor;
+		m_Layers[index] = layer;
+	}
+
+	void RenderQueue2D::Cull(const Frustum& frustum)
+	{
+		SS_PROFILE_FUNCTION();
+
+		const uint32_t spriteCount = GetSpriteCount();
+		m_Bounds.Resize(spriteCount);
+
+		// Sprites are unit quads in the XY plane of their transform
+		JobSystem::ParallelFor(spriteCount, SpritesPerJob, [&](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				const glm::mat4& transform = m_Transforms[i];
+				const glm::vec3 extents = (abs(glm::vec3{transform[0]}) + abs(glm::vec3{transform[1]})) * 0.5f;
+
+				m_Bounds.Set(i, glm::vec3{transform[3]}, extents);
+			}
+		});
+
+		m_VisibleSprites.resize(frustum.Cull(m_Bounds, m_Visibility));
+
+		uint32_t visibleIndex = 0;
+		for (uint32_t i = 0; i < spriteCount; i++)
+		{
+			if (m_Visibility[i])
+			{
+				m_VisibleSprites[visibleIndex++] = i;
+			}
+		}
+	}
+
+	void RenderQueue2D::Sort(const glm::mat4& view)
+	{
+		SS_PROFILE_FUNCTION();
+
+		const auto visibleCount = static_cast<uint32_t>(m_VisibleSprites.size());
+		m_SortEntries.resize(visibleCount);
+
+		// Distance along the view direction, the camera looks down -Z
+		const glm::vec4 depthRow{view[0][2], view[1][2], view[2][2], view[3][2]};
+
+		JobSystem::ParallelFor(visibleCount, SpritesPerJob, [&](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t entry = begin; entry < end; entry++)
+			{
+				const uint32_t i = m_VisibleSprites[entry];
+				const Ref<Texture2D>& texture = m_Textures[i];
+
+				const bool translucent = m_Colors[i].a < 1.0f || (texture && texture->HasAlphaChannel());
+				const uint64_t textureKey = texture ? texture->GetRendererID() & TextureMask : 0;
+
+				const float depth = -dot(depthRow, m_Transforms[i][3]);
+				const uint32_t depthBits = ToSortableBits(depth);
+
+				uint64_t key = static_cast<uint64_t>(m_Layers[i]) << LayerShift;
+				if (translucent)
+				{
+					key |= 1ull << TranslucentShift;
+					key |= static_cast<uint64_t>(~depthBits) << 23; // Furthest first
+					key |= textureKey;
+				}
+				else
+				{
+					key |= textureKey << 32;
+					key |= depthBits; // Nearest first, so the depth test rejects hidden fragments early
+				}
+
+				m_SortEntries[entry] = {key, i};
+			}
+		});
+
+		RadixSort(m_SortEntries, m_SortScratch);
+	}
+
+	void RenderQueue2D::Submit(Renderer2D& renderer)
+	{
+		SS_PROFILE_FUNCTION();
+
+		const auto spriteCount = static_cast<uint32_t>(m_VisibleSprites.size());
+		SS_CORE_ASSERT(m_SortEntries.size() == spriteCount, "RenderQueue2D has to be sorted before submitting!");
+
+		m_SortedTransforms.resize(spriteCount);
+		m_SortedColors.resize(spriteCount);
+		m_SortedTextures.resize(spriteCount);
+		m_SortedUVRects.resize(spriteCount);
+		m_SortedTilingFactors.resize(spriteCount);
+
+		JobSystem::ParallelFor(spriteCount, SpritesPerJob, [&](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				const uint32_t sprite = m_SortEntries[i].Value;
+
+				m_SortedTransforms[i] = m_Transforms[sprite];
+				m_SortedColors[i] = m_Colors[sprite];
+				m_SortedTextures[i] = m_Textures[sprite];
+				m_SortedUVRects[i] = m_UVRects[sprite];
+				m_SortedTilingFactors[i] = m_TilingFactors[sprite];
+			}
+		});
+
+		renderer.DrawQuads(m_SortedTransforms, m_SortedColors, m_SortedTextures, m_SortedTilingFactors, m_SortedUVRects);
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "Texture.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+#include "Snowstorm/Utility/RadixSort.hpp"
+
+namespace Snowstorm
+{
+	class Renderer2D;
+
+	// Collects the sprites of one render target and submits them to a Renderer2D in draw order
+	// Sprites are sorted by layer first, then opaque before translucent. Opaque sprites are grouped by texture to keep
+	// batches long, translucent sprites are drawn back to front so they blend correctly.
+	class RenderQueue2D final : public NonCopyable
+	{
+	public:
+		// Resizes the queue to spriteCount sprites, which can then be set from multiple threads
+		void Resize(uint32_t spriteCount);
+
+		void SetSprite(uint32_t index, const glm::mat4& transform, const glm::vec4& color, const Ref<Texture2D>& texture,
+		               const glm::vec4& uvRect, float tilingFactor, uint8_t layer);
+
+		// Drops the sprites outside of frustum from the following Sort and Submit
+		void Cull(const Frustum& frustum);
+
+		// view is the camera's view matrix, used to get each sprite's depth
+		void Sort(const glm::mat4& view);
+
+		// Records the sorted sprites into the renderer
+		void Submit(Renderer2D& renderer);
+
+		[[nodiscard]] uint32_t GetSpriteCount() const { return static_cast<uint32_t>(m_Transforms.size()); }
+		[[nodiscard]] uint32_t GetCulledCount() const { return GetSpriteCount() - static_cast<uint32_t>(m_VisibleSprites.size()); }
+
+	private:
+		std::vector<glm::mat4> m_Transforms;
+		std::vector<glm::vec4> m_Colors;
+		std::vector<Ref<Texture2D>> m_Textures;
+		std::vector<glm::vec4> m_UVRects;
+		std::vector<float> m_TilingFactors;
+		std::vector<uint8_t> m_Layers;
+
+		PackedBounds m_Bounds;
+		std::vector<uint8_t> m_Visibility;
+		std::vector<uint32_t> m_VisibleSprites; // Indices of the sprites that survived culling
+
+		std::vector<RadixSortEntry> m_SortEntries;
+		std::vector<RadixSortEntry> m_SortScratch;
+
+		// Sprite data in sorted order, handed to Renderer2D::DrawQuads
+		std::vector<glm::mat4> m_SortedTransforms;
+		std::vector<glm::vec4> m_SortedColors;
+		std::vector<Ref<Texture2D>> m_SortedTextures;
+		std::vector<glm::vec4> m_SortedUVRects;
+		std::vector<float> m_SortedTilingFactors;
+	};
+}
@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "RenderQueue3D.hpp"
+
+#include "Renderer3DSingleton.hpp"
+
+#include "Snowstorm/Core/JobSystem.hpp"
+
+namespace Snowstorm
+{
+	namespace
+	{
+		// Packets merged per job
+		constexpr uint32_t BucketsPerJob = 4;
+
+		// Key layout, from the most significant bit:
+		//   shader (16) | batch (16) | mesh (16) | depth front to back (16)
+		// Pointers are hashed down to their field, a collision only interleaves two groups and never changes what is
+		// drawn since the renderer batches by the pointers themselves.
+		constexpr uint32_t ShaderShift = 48;
+		constexpr uint32_t BatchShift = 32;
+		constexpr uint32_t MeshShift = 16;
+
+		uint64_t HashPointer(const void* pointer)
+		{
+			return (reinterpret_cast<uintptr_t>(pointer) >> 4) * 0x9e3779b97f4a7c15ull >> 48;
+		}
+	}
+
+	void RenderQueue3D::Bucket::Add(const glm::mat4& transform, const Ref<Mesh>& mesh, const Ref<Material>& material,
+	                                const float depth)
+	{
+		MeshDrawPacket& packet = m_Packets.emplace_back();
+		packet.Key = HashPointer(material->GetShader().get()) << ShaderShift |
+			HashPointer(material->GetBatchKey()) << BatchShift |
+			HashPointer(mesh.get()) << MeshShift |
+			ToSortableBits(depth) >> 16;
+		packet.Transform = transform;
+		packet.MeshRef = &mesh;
+		packet.MaterialRef = &material;
+	}
+
+	void RenderQueue3D::Record(const uint32_t count, uint32_t chunkSize, const RecordFunction& record)
+	{
+		SS_PROFILE_FUNCTION();
+
+		chunkSize = std::max(chunkSize, 1u);
+		m_BucketCount = (count + chunkSize - 1) / chunkSize;
+		if (m_Buckets.size() < m_BucketCount)
+		{
+			m_Buckets.resize(m_BucketCount);
+		}
+
+		for (uint32_t i = 0; i < m_BucketCount; i++)
+		{
+			m_Buckets[i].m_Packets.clear();
+		}
+
+		// Chunks start at multiples of chunkSize, which makes the bucket index unique to the job
+		JobSystem::ParallelFor(count, chunkSize, [&](const uint32_t begin, const uint32_t end)
+		{
+			record(begin, end, m_Buckets[begin / chunkSize]);
+		});
+	}
+
+	void RenderQueue3D::Sort()
+	{
+		SS_PROFILE_FUNCTION();
+
+		std::vector<uint32_t> offsets(m_BucketCount + 1, 0);
+		for (uint32_t i = 0; i < m_BucketCount; i++)
+		{
+			offsets[i + 1] = offsets[i] + static_cast<uint32_t>(m_Buckets[i].m_Packets.size());
+		}
+
+		m_Packets.resize(offsets.back());
+		m_SortEntries.resize(offsets.back());
+
+		JobSystem::ParallelFor(m_BucketCount, BucketsPerJob, [&](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t bucket = begin; bucket < end; bucket++)
+			{
+				const std::vector<MeshDrawPacket>& packets = m_Buckets[bucket].m_Packets;
+				for (uint32_t i = 0; i < packets.size(); i++)
+				{
+					const uint32_t index = offsets[bucket] + i;
+					m_Packets[index] = packets[i];
+					m_SortEntries[index] = {packets[i].Key, index};
+				}
+			}
+		});
+
+		RadixSort(m_SortEntries, m_SortScratch);
+	}
+
+	void RenderQueue3D::Submit(Renderer3DSingleton& renderer) const
+	{
+		SS_PROFILE_FUNCTION();
+
+		SS_CORE_ASSERT(m_SortEntries.size() == m_Packets.size(), "RenderQueue3D has to be sorted before submitting!");
+
+		for (const RadixSortEntry& entry : m_SortEntries)
+		{
+			const MeshDrawPacket& packet = m_Packets[entry.Value];
+			renderer.DrawMesh(packet.Transform, *packet.MeshRef, *packet.MaterialRef);
+		}
+	}
+}
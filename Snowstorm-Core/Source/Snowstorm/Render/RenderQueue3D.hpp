@@ -0,0 +1,66 @@
+#pragma once
+
+#include <functional>
+
+#include <glm/glm.hpp>
+
+#include "Material.hpp"
+#include "Mesh.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+#include "Snowstorm/Utility/RadixSort.hpp"
+
+namespace Snowstorm
+{
+	class Renderer3DSingleton;
+
+	// One mesh instance to draw, the references point into components that outlive the frame's queue
+	struct MeshDrawPacket
+	{
+		uint64_t Key = 0;
+		glm::mat4 Transform{1.0f};
+		const Ref<Mesh>* MeshRef = nullptr;
+		const Ref<Material>* MaterialRef = nullptr;
+	};
+
+	// Collects the meshes of one render target as draw packets and submits them to Renderer3DSingleton in draw order
+	// Packets are generated by jobs into buckets of their own, then merged and radix sorted by shader, batch, mesh and
+	// finally front to back, so the renderer sees every batch in one run and fills it nearest first.
+	class RenderQueue3D final : public NonCopyable
+	{
+	public:
+		// Filled by a single job, so adding needs no synchronization
+		class Bucket
+		{
+		public:
+			// depth is the distance along the camera's view direction
+			void Add(const glm::mat4& transform, const Ref<Mesh>& mesh, const Ref<Material>& material, float depth);
+
+		private:
+			std::vector<MeshDrawPacket> m_Packets;
+
+			friend class RenderQueue3D;
+		};
+
+		using RecordFunction = std::function<void(uint32_t begin, uint32_t end, Bucket& bucket)>;
+
+		// Replaces the queue's packets with the ones record adds for [0, count), run in chunks on the job system
+		void Record(uint32_t count, uint32_t chunkSize, const RecordFunction& record);
+
+		// Merges the buckets into key order
+		void Sort();
+
+		// Hands the sorted packets to the renderer (render thread only)
+		void Submit(Renderer3DSingleton& renderer) const;
+
+		[[nodiscard]] uint32_t GetPacketCount() const { return static_cast<uint32_t>(m_Packets.size()); }
+
+	private:
+		std::vector<Bucket> m_Buckets; // Kept across frames so their storage keeps its capacity
+		uint32_t m_BucketCount = 0;
+
+		std::vector<MeshDrawPacket> m_Packets;
+		std::vector<RadixSortEntry> m_SortEntries;
+		std::vector<RadixSortEntry> m_SortScratch;
+	};
+}
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "RenderStateCache.hpp"
+
+namespace Snowstorm
+{
+	void RenderStateCache::Reset()
+	{
+		m_Shader = nullptr;
+		m_VertexArray = nullptr;
+		m_Textures.fill(0);
+	}
+
+	void RenderStateCache::BindShader(const Ref<Shader>& shader)
+	{
+		const bool changed = shader.get() != m_Shader;
+		if (changed)
+		{
+			shader->Bind();
+			m_Shader = shader.get();
+		}
+
+		Count(changed);
+	}
+
+	void RenderStateCache::BindTexture(const uint32_t slot, const Ref<Texture>& texture)
+	{
+		SS_CORE_ASSERT(slot < MaxTextureSlots, "Texture slot out of range!");
+
+		const bool changed = texture->GetRendererID() != m_Textures[slot];
+		if (changed)
+		{
+			texture->Bind(slot);
+			m_Textures[slot] = texture->GetRendererID();
+		}
+
+		Count(changed);
+	}
+
+	void RenderStateCache::BindVertexArray(const Ref<VertexArray>& vertexArray)
+	{
+		const bool changed = vertexArray.get() != m_VertexArray;
+		if (changed)
+		{
+			vertexArray->Bind();
+			m_VertexArray = vertexArray.get();
+		}
+
+		Count(changed);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+
+#include "Shader.hpp"
+#include "Texture.hpp"
+#include "VertexArray.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// Remembers the pipeline state it bound and skips binds that wouldn't change anything
+	// Only sees state changed through it, so Reset whenever other code may have bound something in between.
+	// Render thread only.
+	class RenderStateCache final : public NonCopyable
+	{
+	public:
+		static constexpr uint32_t MaxTextureSlots = 32;
+
+		void Reset();
+
+		void BindShader(const Ref<Shader>& shader);
+		void BindTexture(uint32_t slot, const Ref<Texture>& texture);
+		void BindVertexArray(const Ref<VertexArray>& vertexArray);
+
+		// Uploads to the bound shader, which skips values it already holds
+		template <typename T>
+		void SetUniform(const UniformHandle handle, const T& value)
+		{
+			SS_CORE_ASSERT(m_Shader, "No shader bound!");
+			Count(m_Shader->SetUniform(handle, value));
+		}
+
+		struct Statistics
+		{
+			uint32_t IssuedStateChanges = 0;
+			uint32_t SkippedStateChanges = 0;
+		};
+
+		void ResetStats() { m_Stats = {}; }
+		[[nodiscard]] Statistics GetStats() const { return m_Stats; }
+
+	private:
+		void Count(const bool issued)
+		{
+			issued ? m_Stats.IssuedStateChanges++ : m_Stats.SkippedStateChanges++;
+		}
+
+		Shader* m_Shader = nullptr;
+		const VertexArray* m_VertexArray = nullptr;
+		std::array<uint32_t, MaxTextureSlots> m_Textures{}; // Renderer IDs, 0 when unknown
+
+		Statistics m_Stats;
+	};
+}
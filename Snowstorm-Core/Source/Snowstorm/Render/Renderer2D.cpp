@@ -1,83 +1,301 @@
 #include "pch.h"
 #include "Renderer2D.hpp"
 
+#include <bit>
 #include <numeric>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 
 #include "RenderCommand.hpp"
 #include "Shader.hpp"
+#include "StorageBuffer.hpp"
 #include "VertexArray.hpp"
 
+#include "Snowstorm/Core/JobSystem.hpp"
+
 namespace Snowstorm
 {
-	struct QuadVertex
+	namespace
+	{
+		struct QuadVertex
+		{
+			// Left uninitialized so reserving a vertex range doesn't clear it before it gets overwritten
+			QuadVertex()
+			{
+			}
+
+			glm::vec3 Position;
+			glm::vec4 Color;
+			glm::vec2 TexCoord; // Corner of the quad, the shader maps it into UVRect after tiling
+			glm::vec4 UVRect;
+			float TextureIndex;
+			float TilingFactor;
+		};
+
+		// Per-instance record for QuadMode::Instanced, expanded over a static unit quad in the vertex shader
+		struct QuadInstance
+		{
+			// Left uninitialized for the same reason as QuadVertex
+			QuadInstance()
+			{
+			}
+
+			glm::vec4 TransformRows[3]; // Top three rows of the model matrix
+			glm::vec4 UVRect; // Min and max texture coordinates
+			uint32_t Color; // RGBA8
+			float TextureIndex;
+			float TilingFactor;
+		};
+
+		constexpr uint32_t MaxQuads = 20000; // Per draw call, bounded by the shared index buffer
+		constexpr uint32_t MaxIndices = MaxQuads * 6;
+		constexpr uint32_t MaxTextureSlots = 32; // Size of the sampler array in the texture shaders, clamped to RendererCapabilities
+
+		// Shader storage binding of the bindless texture handle table
+		constexpr uint32_t TextureHandleBinding = 1;
+
+		constexpr size_t QuadVertexCount = 4;
+
+		// Quads generated per job by DrawQuads
+		constexpr uint32_t QuadsPerJob = 2048;
+
+		// Quads a stream region holds initially, it grows to fit the largest scene recorded so far
+		constexpr uint32_t InitialStreamQuadCapacity = 8192;
+
+		constexpr glm::vec4 QuadVertexPositions[QuadVertexCount] = {
+			{-0.5f, -0.5f, 0.0f, 1.0f},
+			{0.5f, -0.5f, 0.0f, 1.0f},
+			{0.5f, 0.5f, 0.0f, 1.0f},
+			{-0.5f, 0.5f, 0.0f, 1.0f}
+		};
+
+		constexpr glm::vec2 UnitQuadVertices[QuadVertexCount * 2] = {
+			{-0.5f, -0.5f}, {0.0f, 0.0f},
+			{0.5f, -0.5f}, {1.0f, 0.0f},
+			{0.5f, 0.5f}, {1.0f, 1.0f},
+			{-0.5f, 0.5f}, {0.0f, 1.0f}
+		};
+
+		constexpr glm::vec2 QuadTextureCoords[QuadVertexCount] = {
+			{0.0f, 0.0f},
+			{1.0f, 0.0f},
+			{1.0f, 1.0f},
+			{0.0f, 1.0f}
+		};
+
+		// Min (xy) and max (zw) texture coordinates covering the whole texture
+		constexpr glm::vec4 FullUVRect = {0.0f, 0.0f, 1.0f, 1.0f};
+
+		// GPU resources shared between all Renderer2D instances
+		struct Renderer2DStorage
+		{
+			Ref<IndexBuffer> QuadIndexBuffer;
+			Ref<Shader> TextureShader;
+			Ref<Texture2D> WhiteTexture;
+
+			Ref<VertexBuffer> UnitQuadVertexBuffer;
+			Ref<Shader> InstancedTextureShader;
+
+			// Only loaded if the backend supports bindless textures
+			Ref<Shader> BindlessTextureShader;
+			Ref<Shader> BindlessInstancedTextureShader;
+
+			uint32_t TextureSlotCount = MaxTextureSlots;
+		};
+
+		Renderer2DStorage s_Data;
+
+		uint32_t GetQuadStride(const Renderer2D::QuadMode mode)
+		{
+			return mode == Renderer2D::QuadMode::Instanced
+				       ? static_cast<uint32_t>(sizeof(QuadInstance))
+				       : static_cast<uint32_t>(QuadVertexCount * sizeof(QuadVertex));
+		}
+
+		Ref<VertexArray> CreateQuadVertexArray(const Ref<VertexBuffer>& quadBuffer, const Renderer2D::QuadMode mode)
+		{
+			Ref<VertexArray> vertexArray = VertexArray::Create();
+			vertexArray->Bind();
+
+			if (mode == Renderer2D::QuadMode::Instanced)
+			{
+				quadBuffer->SetLayout({
+					{ShaderDataType::Float4, "a_TransformRow0", true},
+					{ShaderDataType::Float4, "a_TransformRow1", true},
+					{ShaderDataType::Float4, "a_TransformRow2", true},
+					{ShaderDataType::Float4, "a_UVRect", true},
+					{ShaderDataType::Byte4, "a_Color", true, true},
+					{ShaderDataType::Float, "a_TextureIndex", true},
+					{ShaderDataType::Float, "a_TilingFactor", true},
+				});
+				vertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+			}
+			else
+			{
+				quadBuffer->SetLayout({
+					{ShaderDataType::Float3, "a_Position"},
+					{ShaderDataType::Float4, "a_Color"},
+					{ShaderDataType::Float2, "a_TexCoord"},
+					{ShaderDataType::Float4, "a_UVRect"},
+					{ShaderDataType::Float, "a_TextureIndex"},
+					{ShaderDataType::Float, "a_TilingFactor"},
+				});
+			}
+
+			vertexArray->AddVertexBuffer(quadBuffer);
+			vertexArray->SetIndexBuffer(s_Data.QuadIndexBuffer);
+
+			return vertexArray;
+		}
+
+		void DrawQuadRange(const Ref<VertexArray>& vertexArray, const Renderer2D::QuadMode mode, const uint32_t firstQuad,
+		                   const uint32_t quadCount)
+		{
+			vertexArray->Bind();
+
+			if (mode == Renderer2D::QuadMode::Instanced)
+			{
+				RenderCommand::DrawIndexedInstanced(vertexArray, 6, quadCount, firstQuad);
+			}
+			else
+			{
+				RenderCommand::DrawIndexed(vertexArray, quadCount * 6, firstQuad * static_cast<uint32_t>(QuadVertexCount));
+			}
+		}
+
+		void WriteQuad(QuadVertex* vertices, const glm::mat4& transform, const glm::vec4& color, const glm::vec4& uvRect,
+		               const float textureIndex, const float tilingFactor)
+		{
+			for (size_t i = 0; i < QuadVertexCount; i++)
+			{
+				vertices[i].Position = transform * QuadVertexPositions[i];
+				vertices[i].Color = color;
+				vertices[i].TexCoord = QuadTextureCoords[i];
+				vertices[i].UVRect = uvRect;
+				vertices[i].TextureIndex = textureIndex;
+				vertices[i].TilingFactor = tilingFactor;
+			}
+		}
+
+		void WriteQuadInstance(QuadInstance& instance, const glm::mat4& transform, const glm::vec4& color,
+		                       const glm::vec4& uvRect, const float textureIndex, const float tilingFactor)
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				instance.TransformRows[row] = {transform[0][row], transform[1][row], transform[2][row], transform[3][row]};
+			}
+
+			instance.UVRect = uvRect;
+			instance.Color = glm::packUnorm4x8(color);
+			instance.TextureIndex = textureIndex;
+			instance.TilingFactor = tilingFactor;
+		}
+	}
+
+	// A range of recorded quads that can be drawn with a single draw call
+	struct Renderer2DBatch
 	{
-		glm::vec3 Position;
-		glm::vec4 Color;
-		glm::vec2 TexCoord;
-		float TextureIndex;
-		float TilingFactor;
+		uint32_t QuadOffset = 0;
+		uint32_t QuadCount = 0;
+
+		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
+		uint32_t TextureSlotIndex = 1; // 0 = white texture
 	};
 
-	struct MeshInstanceData
+	// Where a texture was placed, keyed on its renderer ID
+	struct Renderer2DTextureSlot
 	{
-		glm::mat4 ModelMatrix;
-		glm::vec4 Color;
-		float TextureIndex;
+		uint32_t Batch = 0; // Slot is only valid within this batch (unused in bindless mode)
+		uint32_t Slot = 0;
+	};
+
+	// GPU buffers for one QuadMode
+	struct Renderer2DQuadBuffers
+	{
+		// Recorded quads are written straight into the current region of this buffer
+		Ref<StreamingVertexBuffer> Stream;
+		Ref<VertexArray> StreamVertexArray;
+		uint32_t StreamQuadCapacity = 0;
+
+		// Quads that didn't fit into the stream region are uploaded through here, created on first use
+		Ref<VertexBuffer> Spill;
+		Ref<VertexArray> SpillVertexArray;
 	};
 
 	struct Renderer2DData
 	{
-		static constexpr uint32_t MaxQuads = 20000;
-		static constexpr uint32_t MaxVertices = MaxQuads * 4;
-		static constexpr uint32_t MaxIndices = MaxQuads * 6;
-		static constexpr uint32_t MaxTextureSlots = 32; // TODO: RenderCaps
+		std::array<Renderer2DQuadBuffers, 2> QuadBuffers; // Indexed by QuadMode
 
-		Ref<VertexArray> QuadVertexArray;
-		Ref<VertexBuffer> QuadVertexBuffer;
-		Ref<Shader> TextureShader;
-		Ref<Texture2D> WhiteTexture;
+		Renderer2D::QuadMode Mode = Renderer2D::QuadMode::Vertices; // Mode of the scene being recorded
+		Renderer2D::QuadMode RequestedMode = Renderer2D::QuadMode::Vertices;
 
-		uint32_t QuadIndexCount = 0;
-		QuadVertex* QuadVertexBufferBase = nullptr;
-		QuadVertex* QuadVertexBufferPtr = nullptr;
+		bool Bindless = false; // Bindless mode of the scene being recorded
+		bool RequestedBindless = false;
 
-		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
-		uint32_t TextureSlotIndex = 1; // 0 = white texture
 
-		glm::vec4 QuadVertexPositions[4];
+		// Mapped stream memory of the current scene
+		uint8_t* StreamData = nullptr;
+		uint32_t StreamBaseQuad = 0; // First quad of the scene's region within the stream buffer
+		uint32_t StreamQuadCapacity = 0;
+
+		// The first StreamedQuadCount quads live in the stream, any quads after them spilled into QuadVertices or
+		// QuadInstances (whichever matches Mode)
+		uint32_t RecordedQuadCount = 0;
+		uint32_t StreamedQuadCount = 0;
+		bool Spilled = false;
+
+		std::vector<QuadVertex> QuadVertices;
+		std::vector<QuadInstance> QuadInstances;
+
+		std::vector<Renderer2DBatch> Batches;
+
+		std::unordered_map<uint32_t, Renderer2DTextureSlot> TextureSlotLookup;
+
+		// Bindless mode: every texture of the scene, indexed by texture index, and their handles on the GPU
+		std::vector<Ref<Texture2D>> BindlessTextures;
+		std::vector<uint64_t> BindlessHandles;
+		Ref<StorageBuffer> TextureHandleBuffer;
+
+		// Per-quad texture indices resolved by DrawQuads before vertex generation
+		std::vector<float> QuadTextureIndices;
 
 		Renderer2D::Statistics Stats;
+
+		Renderer2DQuadBuffers& GetQuadBuffers() { return QuadBuffers[static_cast<size_t>(Mode)]; }
 	};
 
 	namespace
 	{
-		Renderer2DData s_Data;
+		// Returns where quadCount quads starting at RecordedQuadCount get written. Quads go straight into the mapped
+		// stream region while it has room, once it runs out the rest of the scene spills into CPU memory.
+		template <typename T>
+		T* ReserveQuads(Renderer2DData& data, std::vector<T>& spill, const uint32_t quadCount, const size_t elementsPerQuad)
+		{
+			const uint32_t firstQuad = data.RecordedQuadCount;
+			data.RecordedQuadCount += quadCount;
+
+			if (!data.Spilled && data.RecordedQuadCount <= data.StreamQuadCapacity)
+			{
+				data.StreamedQuadCount = data.RecordedQuadCount;
+				return reinterpret_cast<T*>(data.StreamData) + firstQuad * elementsPerQuad;
+			}
+
+			data.Spilled = true;
+
+			const size_t spillOffset = (firstQuad - data.StreamedQuadCount) * elementsPerQuad;
+			spill.resize(spillOffset + quadCount * elementsPerQuad);
+			return &spill[spillOffset];
+		}
 	}
 
 	void Renderer2D::Init()
 	{
 		SS_PROFILE_FUNCTION();
 
-		s_Data.QuadVertexArray = VertexArray::Create();
-		s_Data.QuadVertexArray->Bind();
-
-		s_Data.QuadVertexBuffer = VertexBuffer::Create(Renderer2DData::MaxVertices * sizeof(QuadVertex));
-		s_Data.QuadVertexBuffer->SetLayout({
-			{ShaderDataType::Float3, "a_Position"},
-			{ShaderDataType::Float4, "a_Color"},
-			{ShaderDataType::Float2, "a_TexCoord"},
-			{ShaderDataType::Float, "a_TextureIndex"},
-			{ShaderDataType::Float, "a_TilingFactor"},
-		});
-		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadVertexBuffer);
-
-		s_Data.QuadVertexBufferBase = new QuadVertex[Renderer2DData::MaxVertices];
-
-		const auto quadIndices = new uint32_t[Renderer2DData::MaxIndices];
+		const auto quadIndices = new uint32_t[MaxIndices];
 
 		uint32_t offset = 0;
-		for (uint32_t i = 0; i < Renderer2DData::MaxIndices; i += 6)
+		for (uint32_t i = 0; i < MaxIndices; i += 6)
 		{
 			quadIndices[i + 0] = offset + 0;
 			quadIndices[i + 1] = offset + 1;
@@ -90,182 +308,476 @@ namespace Snowstorm
 			offset += 4;
 		}
 
-		const Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices, Renderer2DData::MaxIndices);
-		s_Data.QuadVertexArray->SetIndexBuffer(quadIB);
+		s_Data.QuadIndexBuffer = IndexBuffer::Create(quadIndices, MaxIndices);
 		delete[] quadIndices;
 
 		s_Data.WhiteTexture = Texture2D::Create(1, 1);
 		uint32_t whiteTextureData = 0xffffffff;
 		s_Data.WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
 
-		std::vector<int32_t> samplers(Renderer2DData::MaxTextureSlots);
+		std::vector<int32_t> samplers(MaxTextureSlots);
 		std::iota(samplers.begin(), samplers.end(), 0);
 
 		s_Data.TextureShader = Shader::Create("assets/shaders/Texture.glsl");
 		s_Data.TextureShader->Bind();
 		s_Data.TextureShader->SetUniform("u_Textures", samplers);
 
-		s_Data.TextureSlots[0] = s_Data.WhiteTexture;
+		s_Data.UnitQuadVertexBuffer = VertexBuffer::Create(UnitQuadVertices, sizeof(UnitQuadVertices));
+		s_Data.UnitQuadVertexBuffer->SetLayout({
+			{ShaderDataType::Float2, "a_LocalPosition"},
+			{ShaderDataType::Float2, "a_LocalTexCoord"},
+		});
 
-		s_Data.QuadVertexPositions[0] = {-0.5f, -0.5f, 0.0f, 1.0f};
-		s_Data.QuadVertexPositions[1] = {0.5f, -0.5f, 0.0f, 1.0f};
-		s_Data.QuadVertexPositions[2] = {0.5f, 0.5f, 0.0f, 1.0f};
-		s_Data.QuadVertexPositions[3] = {-0.5f, 0.5f, 0.0f, 1.0f};
+		s_Data.InstancedTextureShader = Shader::Create("assets/shaders/TextureInstanced.glsl");
+		s_Data.InstancedTextureShader->Bind();
+		s_Data.InstancedTextureShader->SetUniform("u_Textures", samplers);
+
+		const RendererCapabilities& capabilities = RenderCommand::GetCapabilities();
+
+		s_Data.TextureSlotCount = std::clamp(capabilities.MaxTextureSlots, 2u, MaxTextureSlots);
+
+		if (capabilities.BindlessTextures)
+		{
+			s_Data.BindlessTextureShader = Shader::Create("assets/shaders/TextureBindless.glsl");
+			s_Data.BindlessInstancedTextureShader = Shader::Create("assets/shaders/TextureInstancedBindless.glsl");
+		}
 	}
 
 	void Renderer2D::Shutdown()
 	{
 		SS_PROFILE_FUNCTION();
+
+		s_Data = {};
 	}
 
-	void Renderer2D::BeginScene(const Camera& camera, const glm::mat4& transform)
+	Renderer2D::Renderer2D()
+		: m_Data(CreateScope<Renderer2DData>())
 	{
 		SS_PROFILE_FUNCTION();
 
-		const glm::mat4 viewProj = camera.GetProjection() * inverse(transform);
+		SS_CORE_ASSERT(s_Data.TextureShader, "Renderer2D::Init has to be called before creating a renderer!");
+	}
 
-		s_Data.TextureShader->Bind();
-		s_Data.TextureShader->SetUniform("u_ViewProjection", viewProj);
+	Renderer2D::~Renderer2D() = default;
+
+	void Renderer2D::BeginScene()
+	{
+		SS_PROFILE_FUNCTION();
+
+		const uint32_t previousQuadCount = m_Data->RecordedQuadCount;
+
+		m_Data->Mode = m_Data->RequestedMode;
+		m_Data->Bindless = m_Data->RequestedBindless && s_Data.BindlessTextureShader;
+
+		const uint32_t stride = GetQuadStride(m_Data->Mode);
+		Renderer2DQuadBuffers& buffers = m_Data->GetQuadBuffers();
+
+		// (Re)create the stream so it fits the previous scene, a scene that spilled only pays for it once
+		if (!buffers.Stream || buffers.StreamQuadCapacity < previousQuadCount)
+		{
+			buffers.StreamQuadCapacity = std::max(InitialStreamQuadCapacity, std::bit_ceil(previousQuadCount));
+			buffers.Stream = StreamingVertexBuffer::Create(buffers.StreamQuadCapacity * stride);
+			buffers.StreamVertexArray = CreateQuadVertexArray(buffers.Stream, m_Data->Mode);
+		}
+
+		buffers.Stream->BeginFrame();
+
+		const auto allocation = buffers.Stream->Allocate(buffers.StreamQuadCapacity * stride, stride);
+		m_Data->StreamData = static_cast<uint8_t*>(allocation.Data);
+		m_Data->StreamBaseQuad = allocation.Offset / stride;
+		m_Data->StreamQuadCapacity = allocation.Data ? buffers.StreamQuadCapacity : 0;
+
+		m_Data->RecordedQuadCount = 0;
+		m_Data->StreamedQuadCount = 0;
+		m_Data->Spilled = false;
 
-		s_Data.QuadIndexCount = 0;
-		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
+		m_Data->QuadVertices.clear();
+		m_Data->QuadInstances.clear();
+		m_Data->Batches.clear();
 
-		s_Data.TextureSlotIndex = 1;
+		m_Data->TextureSlotLookup.clear();
+		m_Data->BindlessTextures.clear();
+		if (m_Data->Bindless)
+		{
+			m_Data->BindlessTextures.push_back(s_Data.WhiteTexture); // 0 = white texture
+		}
+
+		NextBatch();
 	}
 
 	void Renderer2D::EndScene()
 	{
 		SS_PROFILE_FUNCTION();
 
-		const uint32_t dataSize = reinterpret_cast<uint8_t*>(s_Data.QuadVertexBufferPtr) - reinterpret_cast<uint8_t*>(
-			s_Data.QuadVertexBufferBase);
-		s_Data.QuadVertexBuffer->SetData(s_Data.QuadVertexBufferBase, dataSize);
-
-		Flush();
+		// Drop the trailing batch if nothing was recorded into it
+		if (!m_Data->Batches.empty() && m_Data->Batches.back().QuadCount == 0)
+		{
+			m_Data->Batches.pop_back();
+		}
 	}
 
 	void Renderer2D::Flush()
 	{
-		s_Data.QuadVertexArray->Bind();
+		SS_PROFILE_FUNCTION();
 
-		// Bind textures
-		for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
+		if (m_Data->Batches.empty())
 		{
-			s_Data.TextureSlots[i]->Bind(i);
+			return;
 		}
 
-		// Bind shader
-		s_Data.TextureShader->Bind();
+		const QuadMode mode = m_Data->Mode;
+		const uint32_t stride = GetQuadStride(mode);
+		Renderer2DQuadBuffers& buffers = m_Data->GetQuadBuffers();
+
+		if (m_Data->Spilled && !buffers.Spill)
+		{
+			buffers.Spill = VertexBuffer::Create(MaxQuads * stride);
+			buffers.SpillVertexArray = CreateQuadVertexArray(buffers.Spill, mode);
+		}
+
+		Ref<Shader> shader;
+		if (m_Data->Bindless)
+		{
+			shader = mode == QuadMode::Instanced ? s_Data.BindlessInstancedTextureShader : s_Data.BindlessTextureShader;
+		}
+		else
+		{
+			shader = mode == QuadMode::Instanced ? s_Data.InstancedTextureShader : s_Data.TextureShader;
+		}
 
-		// SS_INFO("Flushing");
+		shader->Bind();
 
-		RenderCommand::DrawIndexed(s_Data.QuadVertexArray, s_Data.QuadIndexCount);
-		s_Data.QuadVertexArray->Unbind();
+		// Handles are only requested here since creating them touches the graphics API
+		if (m_Data->Bindless)
+		{
+			auto& handles = m_Data->BindlessHandles;
+			handles.resize(m_Data->BindlessTextures.size());
+			for (size_t i = 0; i < handles.size(); i++)
+			{
+				handles[i] = m_Data->BindlessTextures[i]->GetBindlessHandle();
+			}
 
-		s_Data.Stats.DrawCalls++;
+			const auto size = static_cast<uint32_t>(handles.size() * sizeof(uint64_t));
+			if (!m_Data->TextureHandleBuffer)
+			{
+				m_Data->TextureHandleBuffer = StorageBuffer::Create(size, TextureHandleBinding);
+			}
+
+			m_Data->TextureHandleBuffer->SetData(handles.data(), size);
+			m_Data->TextureHandleBuffer->Bind();
+		}
+
+		for (const auto& batch : m_Data->Batches)
+		{
+			if (batch.QuadCount == 0)
+			{
+				continue;
+			}
+
+			// Bind textures
+			if (!m_Data->Bindless)
+			{
+				s_Data.WhiteTexture->Bind(0);
+				for (uint32_t i = 1; i < batch.TextureSlotIndex; i++)
+				{
+					batch.TextureSlots[i]->Bind(i);
+				}
+			}
+
+			const uint32_t batchEnd = batch.QuadOffset + batch.QuadCount;
+
+			// Streamed quads are already in GPU memory
+			if (batch.QuadOffset < m_Data->StreamedQuadCount)
+			{
+				const uint32_t quadCount = std::min(batchEnd, m_Data->StreamedQuadCount) - batch.QuadOffset;
+				DrawQuadRange(buffers.StreamVertexArray, mode, m_Data->StreamBaseQuad + batch.QuadOffset, quadCount);
+
+				m_Data->Stats.DrawCalls++;
+				m_Data->Stats.UploadBytes += static_cast<uint64_t>(quadCount) * stride;
+			}
+
+			// Spilled quads still need a copy
+			if (batchEnd > m_Data->StreamedQuadCount)
+			{
+				const uint32_t firstQuad = std::max(batch.QuadOffset, m_Data->StreamedQuadCount);
+				const uint32_t quadCount = batchEnd - firstQuad;
+				const uint32_t spillQuad = firstQuad - m_Data->StreamedQuadCount;
+
+				const void* data = mode == QuadMode::Instanced
+					                   ? static_cast<const void*>(&m_Data->QuadInstances[spillQuad])
+					                   : static_cast<const void*>(&m_Data->QuadVertices[spillQuad * QuadVertexCount]);
+				buffers.Spill->SetData(data, quadCount * stride);
+
+				DrawQuadRange(buffers.SpillVertexArray, mode, 0, quadCount);
+
+				m_Data->Stats.DrawCalls++;
+				m_Data->Stats.UploadBytes += static_cast<uint64_t>(quadCount) * stride;
+			}
+		}
+
+		// Lets the stream know when the GPU is done reading this region
+		buffers.Stream->EndFrame();
+
+		buffers.StreamVertexArray->Unbind();
 	}
 
-	void Renderer2D::FlushAndReset()
+	void Renderer2D::SetQuadMode(const QuadMode mode)
 	{
-		EndScene();
+		m_Data->RequestedMode = mode;
+	}
 
-		s_Data.QuadIndexCount = 0;
-		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
+	Renderer2D::QuadMode Renderer2D::GetQuadMode() const
+	{
+		return m_Data->RequestedMode;
+	}
+
+	void Renderer2D::SetBindlessTextures(const bool enabled)
+	{
+		if (enabled && !SupportsBindlessTextures())
+		{
+			SS_CORE_WARN("Bindless textures are not supported by this device, staying on texture slots");
+			return;
+		}
 
-		s_Data.TextureSlotIndex = 1;
+		m_Data->RequestedBindless = enabled;
 	}
 
-	void Renderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color)
+	bool Renderer2D::UsesBindlessTextures() const
 	{
-		SS_PROFILE_FUNCTION();
+		return m_Data->RequestedBindless;
+	}
 
-		constexpr size_t quadVertexCount = 4;
-		constexpr glm::vec2 textureCoords[] = {
-			{0.0f, 0.0f},
-			{1.0f, 0.0f},
-			{1.0f, 1.0f},
-			{0.0f, 1.0f}
-		};
+	bool Renderer2D::SupportsBindlessTextures()
+	{
+		return s_Data.BindlessTextureShader != nullptr;
+	}
+
+	void Renderer2D::NextBatch()
+	{
+		// DrawQuads counts quads into batches before reserving them, so RecordedQuadCount may still lag behind
+		const uint32_t quadOffset = m_Data->Batches.empty()
+			                            ? m_Data->RecordedQuadCount
+			                            : m_Data->Batches.back().QuadOffset + m_Data->Batches.back().QuadCount;
+
+		Renderer2DBatch& batch = m_Data->Batches.emplace_back();
+		batch.QuadOffset = quadOffset;
+	}
+
+	void Renderer2D::RecordQuad(const glm::mat4& transform, const glm::vec4& color, const glm::vec4& uvRect,
+	                            const float textureIndex, const float tilingFactor)
+	{
+		if (m_Data->Mode == QuadMode::Instanced)
+		{
+			QuadInstance* instance = ReserveQuads(*m_Data, m_Data->QuadInstances, 1, 1);
+			WriteQuadInstance(*instance, transform, color, uvRect, textureIndex, tilingFactor);
+		}
+		else
+		{
+			QuadVertex* vertices = ReserveQuads(*m_Data, m_Data->QuadVertices, 1, QuadVertexCount);
+			WriteQuad(vertices, transform, color, uvRect, textureIndex, tilingFactor);
+		}
+
+		m_Data->Batches.back().QuadCount++;
+		m_Data->Stats.QuadCount++;
+	}
+
+	float Renderer2D::GetTextureIndex(const Ref<Texture2D>& texture)
+	{
+		const auto slot = static_cast<float>(GetTextureSlot(texture));
+
+		// Negative indices tell the shaders to threshold the texture as a distance field
+		return texture->IsDistanceField() ? -(slot + 1.0f) : slot;
+	}
 
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
+	uint32_t Renderer2D::GetTextureSlot(const Ref<Texture2D>& texture)
+	{
+		auto [it, inserted] = m_Data->TextureSlotLookup.try_emplace(texture->GetRendererID());
+		Renderer2DTextureSlot& entry = it->second;
+
+		// A single table covers the whole scene
+		if (m_Data->Bindless)
 		{
-			FlushAndReset();
+			if (inserted)
+			{
+				entry.Slot = static_cast<uint32_t>(m_Data->BindlessTextures.size());
+				m_Data->BindlessTextures.push_back(texture);
+			}
+
+			return entry.Slot;
 		}
 
-		for (size_t i = 0; i < quadVertexCount; i++)
+		if (const auto currentBatch = static_cast<uint32_t>(m_Data->Batches.size() - 1);
+			!inserted && entry.Batch == currentBatch)
 		{
-			constexpr float textureIndex = 0.0f;
-			constexpr float tilingFactor = 1.0f;
+			return entry.Slot;
+		}
 
-			s_Data.QuadVertexBufferPtr[i].Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr[i].Color = color;
-			s_Data.QuadVertexBufferPtr[i].TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr[i].TextureIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr[i].TilingFactor = tilingFactor;
+		// Out of slots, continue in a new batch
+		if (m_Data->Batches.back().TextureSlotIndex >= s_Data.TextureSlotCount)
+		{
+			NextBatch();
 		}
 
-		s_Data.QuadVertexBufferPtr += quadVertexCount;
-		s_Data.QuadIndexCount += 6;
+		Renderer2DBatch& batch = m_Data->Batches.back();
+
+		entry.Batch = static_cast<uint32_t>(m_Data->Batches.size() - 1);
+		entry.Slot = batch.TextureSlotIndex;
+
+		batch.TextureSlots[batch.TextureSlotIndex] = texture;
+		batch.TextureSlotIndex++;
 
-		s_Data.Stats.QuadCount++;
+		return entry.Slot;
+	}
+
+	void Renderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color)
+	{
+		SS_PROFILE_FUNCTION();
+
+		if (m_Data->Batches.back().QuadCount >= MaxQuads)
+		{
+			NextBatch();
+		}
+
+		constexpr float textureIndex = 0.0f;
+		constexpr float tilingFactor = 1.0f;
+
+		RecordQuad(transform, color, FullUVRect, textureIndex, tilingFactor);
 	}
 
 	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, const float tilingFactor, const glm::vec4& tintColor)
 	{
 		SS_PROFILE_FUNCTION();
 
-		constexpr size_t quadVertexCount = 4;
-		constexpr glm::vec2 textureCoords[] = {
-			{0.0f, 0.0f},
-			{1.0f, 0.0f},
-			{1.0f, 1.0f},
-			{0.0f, 1.0f}
-		};
+		if (m_Data->Batches.back().QuadCount >= MaxQuads)
+		{
+			NextBatch();
+		}
+
+		const float textureIndex = GetTextureIndex(texture);
+
+		RecordQuad(transform, tintColor, FullUVRect, textureIndex, tilingFactor);
+	}
 
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
+	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subTexture, const float tilingFactor,
+	                          const glm::vec4& tintColor)
+	{
+		SS_PROFILE_FUNCTION();
+
+		if (m_Data->Batches.back().QuadCount >= MaxQuads)
 		{
-			FlushAndReset();
+			NextBatch();
 		}
 
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
+		const float textureIndex = GetTextureIndex(subTexture->GetTexture());
+
+		const glm::vec2* texCoords = subTexture->GetTexCoords();
+		const glm::vec4 uvRect = {texCoords[0], texCoords[2]};
+
+		RecordQuad(transform, tintColor, uvRect, textureIndex, tilingFactor);
+	}
+
+	void Renderer2D::DrawQuads(const std::span<const glm::mat4> transforms, const std::span<const glm::vec4> colors,
+	                           const std::span<const Ref<Texture2D>> textures, const std::span<const float> tilingFactors,
+	                           const std::span<const glm::vec4> uvRects)
+	{
+		SS_PROFILE_FUNCTION();
+
+		const auto quadCount = static_cast<uint32_t>(transforms.size());
+		if (quadCount == 0)
+		{
+			return;
+		}
+
+		SS_CORE_ASSERT(colors.size() == 1 || colors.size() == quadCount, "Color count doesn't match quad count!");
+		SS_CORE_ASSERT(textures.size() <= 1 || textures.size() == quadCount, "Texture count doesn't match quad count!");
+		SS_CORE_ASSERT(tilingFactors.size() <= 1 || tilingFactors.size() == quadCount,
+		               "Tiling factor count doesn't match quad count!");
+		SS_CORE_ASSERT(uvRects.size() <= 1 || uvRects.size() == quadCount, "UV rect count doesn't match quad count!");
+
+		// Batch splits and texture slots depend on submission order, so they are resolved serially up front
+		auto& textureIndices = m_Data->QuadTextureIndices;
+		textureIndices.resize(quadCount);
+
+		for (uint32_t i = 0; i < quadCount; i++)
 		{
-			if (*s_Data.TextureSlots[i] == *texture)
+			if (m_Data->Batches.back().QuadCount >= MaxQuads)
+			{
+				NextBatch();
+			}
+
+			if (textures.empty())
+			{
+				textureIndices[i] = 0.0f;
+			}
+			else
 			{
-				textureIndex = static_cast<float>(i);
-				break;
+				const Ref<Texture2D>& texture = textures.size() == 1 ? textures[0] : textures[i];
+				textureIndices[i] = texture ? GetTextureIndex(texture) : 0.0f;
 			}
+
+			m_Data->Batches.back().QuadCount++;
 		}
 
-		if (textureIndex == 0.0f)
+		// Batches are consecutive quad ranges, so all quads land in one contiguous reserved range
+		SS_CORE_ASSERT(m_Data->Batches.back().QuadOffset + m_Data->Batches.back().QuadCount ==
+		               m_Data->RecordedQuadCount + quadCount, "Batches don't cover the quads about to be reserved!");
+		const auto getColor = [&](const uint32_t i) -> const glm::vec4& { return colors.size() == 1 ? colors[0] : colors[i]; };
+		const auto getTilingFactor = [&](const uint32_t i)
 		{
-			textureIndex = static_cast<float>(s_Data.TextureSlotIndex);
-			s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
-			s_Data.TextureSlotIndex++;
-		}
+			if (tilingFactors.empty())
+			{
+				return 1.0f;
+			}
+
+			return tilingFactors.size() == 1 ? tilingFactors[0] : tilingFactors[i];
+		};
+		const auto getUVRect = [&](const uint32_t i) -> const glm::vec4&
+		{
+			if (uvRects.empty())
+			{
+				return FullUVRect;
+			}
+
+			return uvRects.size() == 1 ? uvRects[0] : uvRects[i];
+		};
 
-		for (size_t i = 0; i < quadVertexCount; i++)
+		if (m_Data->Mode == QuadMode::Instanced)
 		{
-			s_Data.QuadVertexBufferPtr[i].Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr[i].Color = tintColor;
-			s_Data.QuadVertexBufferPtr[i].TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr[i].TextureIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr[i].TilingFactor = tilingFactor;
+			QuadInstance* instances = ReserveQuads(*m_Data, m_Data->QuadInstances, quadCount, 1);
+
+			JobSystem::ParallelFor(quadCount, QuadsPerJob, [&](const uint32_t begin, const uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					WriteQuadInstance(instances[i], transforms[i], getColor(i), getUVRect(i), textureIndices[i],
+					                  getTilingFactor(i));
+				}
+			});
 		}
+		else
+		{
+			QuadVertex* vertices = ReserveQuads(*m_Data, m_Data->QuadVertices, quadCount, QuadVertexCount);
 
-		s_Data.QuadVertexBufferPtr += quadVertexCount;
-		s_Data.QuadIndexCount += 6;
+			JobSystem::ParallelFor(quadCount, QuadsPerJob, [&](const uint32_t begin, const uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					WriteQuad(vertices + i * QuadVertexCount, transforms[i], getColor(i), getUVRect(i), textureIndices[i],
+					          getTilingFactor(i));
+				}
+			});
+		}
 
-		s_Data.Stats.QuadCount++;
+		m_Data->Stats.QuadCount += quadCount;
 	}
 
 	void Renderer2D::ResetStats()
 	{
-		memset(&s_Data.Stats, 0, sizeof(Statistics));
+		m_Data->Stats = {};
 	}
 
-	Renderer2D::Statistics Renderer2D::GetStats()
+	Renderer2D::Statistics Renderer2D::GetStats() const
 	{
-		return s_Data.Stats;
+		return m_Data->Stats;
 	}
 }
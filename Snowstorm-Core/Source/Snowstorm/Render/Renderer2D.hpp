@@ -1,44 +1,99 @@
 #pragma once
 
+#include <span>
+
 #include "Camera.hpp"
 #include "RendererAPI.h"
+#include "SubTexture2D.hpp"
 #include "Texture.hpp"
 
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
 namespace Snowstorm
 {
+	struct Renderer2DData;
+
 	// Batch renderer for 2D quads
-	class Renderer2D
+	// Every instance records into its own batches without touching the graphics API, so separate instances
+	// (one per render target) can be filled from different threads. Quads are written straight into a mapped
+	// streaming buffer. BeginScene and Flush have to be called from the render thread.
+	class Renderer2D final : public NonCopyable
 	{
 	public:
+		// How quads are laid out in GPU memory
+		enum class QuadMode : uint8_t
+		{
+			Vertices, // Four pre-transformed vertices per quad
+			Instanced // One compact instance record per quad, expanded in the vertex shader
+		};
+
+		Renderer2D();
+		~Renderer2D() override;
+
+		// Resources shared by all instances (shader, white texture, quad indices)
 		static void Init();
 		static void Shutdown();
 
-		static void BeginScene(const Camera& camera, const glm::mat4& transform);
-		static void EndScene();
+		// Draws with the view bound at ViewSingleton::Binding when flushing
+		void BeginScene();
+		void EndScene();
+
+		void Flush();
+
+		// Takes effect at the next BeginScene
+		void SetQuadMode(QuadMode mode);
+		[[nodiscard]] QuadMode GetQuadMode() const;
 
-		static void Flush();
+		// Samples textures through bindless handles instead of a fixed set of texture slots, which lets a batch use
+		// any number of textures. Takes effect at the next BeginScene, ignored if the device doesn't support it.
+		void SetBindlessTextures(bool enabled);
+		[[nodiscard]] bool UsesBindlessTextures() const;
+		[[nodiscard]] static bool SupportsBindlessTextures();
 
 		// Primitives
-		static void DrawQuad(const glm::mat4& transform, const glm::vec4& color);
-		static void DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor);
+		void DrawQuad(const glm::mat4& transform, const glm::vec4& color);
+		void DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor);
+		void DrawQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subTexture, float tilingFactor, const glm::vec4& tintColor);
+
+		// Records transforms.size() quads in one go, generating their vertices on the job system.
+		// colors, textures, tilingFactors and uvRects hold either a single value shared by every quad or one value per
+		// transform. An empty textures span draws untextured quads, an empty tilingFactors span uses 1.0 and an empty
+		// uvRects span maps the whole texture. UV rects store the min texture coordinate in xy and the max in zw,
+		// tiling scales them.
+		void DrawQuads(std::span<const glm::mat4> transforms, std::span<const glm::vec4> colors,
+		               std::span<const Ref<Texture2D>> textures = {}, std::span<const float> tilingFactors = {},
+		               std::span<const glm::vec4> uvRects = {});
 
 		// Stats
 		struct Statistics
 		{
 			uint32_t DrawCalls = 0;
 			uint32_t QuadCount = 0;
+			uint64_t UploadBytes = 0; // Quad data uploaded to the GPU
+			uint32_t CulledQuadCount = 0; // Quads dropped by frustum culling before reaching the renderer
 
 			[[nodiscard]] uint32_t GetTotalVertexCount() const { return QuadCount * 4; }
 			[[nodiscard]] uint32_t GetTotalIndexCount() const { return QuadCount * 6; }
+			[[nodiscard]] float GetQuadsPerDrawCall() const
+			{
+				return DrawCalls ? static_cast<float>(QuadCount) / static_cast<float>(DrawCalls) : 0.0f;
+			}
 		};
 
-		static void ResetStats();
-		static Statistics GetStats();
+		void ResetStats();
+		[[nodiscard]] Statistics GetStats() const;
 
 		// API
 		static RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
 
 	private:
-		static void FlushAndReset();
+		// Starts a batch right after the quads of the current one
+		void NextBatch();
+		float GetTextureIndex(const Ref<Texture2D>& texture);
+		uint32_t GetTextureSlot(const Ref<Texture2D>& texture);
+		void RecordQuad(const glm::mat4& transform, const glm::vec4& color, const glm::vec4& uvRect, float textureIndex,
+		                float tilingFactor);
+
+		Scope<Renderer2DData> m_Data;
 	};
 }
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "Renderer2DSingleton.hpp"
+
+#include <ranges>
+
+namespace Snowstorm
+{
+	Renderer2D& Renderer2DSingleton::GetRenderer(const entt::entity renderTarget)
+	{
+		auto& renderer = m_Renderers[renderTarget];
+		if (!renderer)
+		{
+			renderer = CreateScope<Renderer2D>();
+			renderer->SetQuadMode(m_QuadMode);
+			renderer->SetBindlessTextures(m_BindlessTextures);
+		}
+
+		return *renderer;
+	}
+
+	RenderQueue2D& Renderer2DSingleton::GetQueue(const entt::entity renderTarget)
+	{
+		auto& queue = m_Queues[renderTarget];
+		if (!queue)
+		{
+			queue = CreateScope<RenderQueue2D>();
+		}
+
+		return *queue;
+	}
+
+	void Renderer2DSingleton::PruneTargets(const std::function<bool(entt::entity)>& isLive)
+	{
+		std::erase_if(m_Renderers, [&](const auto& renderer) { return !isLive(renderer.first); });
+		std::erase_if(m_Queues, [&](const auto& queue) { return !isLive(queue.first); });
+	}
+
+	void Renderer2DSingleton::SetQuadMode(const Renderer2D::QuadMode mode)
+	{
+		m_QuadMode = mode;
+		for (const auto& renderer : m_Renderers | std::views::values)
+		{
+			renderer->SetQuadMode(mode);
+		}
+	}
+
+	void Renderer2DSingleton::SetBindlessTextures(const bool enabled)
+	{
+		m_BindlessTextures = enabled && Renderer2D::SupportsBindlessTextures();
+		for (const auto& renderer : m_Renderers | std::views::values)
+		{
+			renderer->SetBindlessTextures(m_BindlessTextures);
+		}
+	}
+
+	void Renderer2DSingleton::ResetStats()
+	{
+		for (const auto& renderer : m_Renderers | std::views::values)
+		{
+			renderer->ResetStats();
+		}
+
+		m_TilemapRenderer.ResetStats();
+	}
+
+	Renderer2D::Statistics Renderer2DSingleton::GetStats() const
+	{
+		Renderer2D::Statistics total;
+		for (const auto& renderer : m_Renderers | std::views::values)
+		{
+			const auto stats = renderer->GetStats();
+			total.DrawCalls += stats.DrawCalls;
+			total.QuadCount += stats.QuadCount;
+			total.UploadBytes += stats.UploadBytes;
+		}
+
+		for (const auto& queue : m_Queues | std::views::values)
+		{
+			total.CulledQuadCount += queue->GetCulledCount();
+		}
+
+		return total;
+	}
+}
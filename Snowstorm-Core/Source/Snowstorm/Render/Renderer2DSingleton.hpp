@@ -0,0 +1,55 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+
+#include <entt/entt.hpp>
+
+#include "RenderQueue2D.hpp"
+#include "Renderer2D.hpp"
+#include "TextureAtlas.hpp"
+#include "TilemapRenderer.hpp"
+
+#include "Snowstorm/ECS/Singleton.hpp"
+
+namespace Snowstorm
+{
+	// Owns one Renderer2D and sprite queue per render target so targets can be recorded independently
+	class Renderer2DSingleton final : public Singleton
+	{
+	public:
+		// Creates the renderer on first use, which allocates GPU resources (render thread only)
+		Renderer2D& GetRenderer(entt::entity renderTarget);
+		RenderQueue2D& GetQueue(entt::entity renderTarget);
+
+		// Frees the renderer and queue of every target isLive rejects, call it with the targets still in the world
+		void PruneTargets(const std::function<bool(entt::entity)>& isLive);
+
+		// Tilemaps are drawn immediately, so one renderer serves every target
+		TilemapRenderer& GetTilemapRenderer() { return m_TilemapRenderer; }
+
+		// Applies to every renderer, including ones created later
+		void SetQuadMode(Renderer2D::QuadMode mode);
+		[[nodiscard]] Renderer2D::QuadMode GetQuadMode() const { return m_QuadMode; }
+
+		void SetBindlessTextures(bool enabled);
+		[[nodiscard]] bool UsesBindlessTextures() const { return m_BindlessTextures; }
+
+		// Sprites added while an atlas is set are drawn from its pages if their image was packed into it, so they can
+		// share batches, see TextureAtlas::Remap
+		void SetSpriteAtlas(Ref<TextureAtlas> atlas) { m_SpriteAtlas = std::move(atlas); }
+		[[nodiscard]] const Ref<TextureAtlas>& GetSpriteAtlas() const { return m_SpriteAtlas; }
+
+		void ResetStats();
+		[[nodiscard]] Renderer2D::Statistics GetStats() const;
+		[[nodiscard]] TilemapRenderer::Statistics GetTilemapStats() const { return m_TilemapRenderer.GetStats(); }
+
+	private:
+		std::unordered_map<entt::entity, Scope<Renderer2D>> m_Renderers;
+		std::unordered_map<entt::entity, Scope<RenderQueue2D>> m_Queues;
+		TilemapRenderer m_TilemapRenderer;
+		Ref<TextureAtlas> m_SpriteAtlas;
+		Renderer2D::QuadMode m_QuadMode = Renderer2D::QuadMode::Vertices;
+		bool m_BindlessTextures = false;
+	};
+}
@@ -1,20 +1,58 @@
 #include "Renderer3DSingleton.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <tuple>
+
 #include "RenderCommand.hpp"
 
 namespace Snowstorm
 {
-	Renderer3DSingleton::Renderer3DSingleton()
+	namespace
 	{
-		m_CameraUBO = UniformBuffer::Create(sizeof(glm::mat4), 0); // Binding = 0
+		// Instances a stream region holds initially, it grows to fit the largest scene recorded so far
+		constexpr uint32_t InitialInstanceStreamCapacity = 4096;
+
+		// Draws are ordered front to back by depth buckets rather than exact depths, which keeps the sorts at a few
+		// radix passes. ToSortableBits keeps a float's exponent on top, dropping low bits leaves logarithmic buckets.
+		constexpr uint32_t RunDepthShift = 20; // 8 buckets per doubling of distance
+		constexpr uint32_t BatchDepthShift = 16; // 128, the buckets RenderQueue3D sorts instances by
+
+		uint64_t GetDepthBucket(const float depth, const uint32_t shift)
+		{
+			return ToSortableBits(depth) >> shift;
+		}
 	}
 
-	void Renderer3DSingleton::BeginScene(const Camera& camera, const glm::mat4& transform)
+	void Renderer3DSingleton::BeginFrame()
 	{
-		const glm::mat4 viewProj = camera.GetProjection() * inverse(transform);
-		m_CameraUBO->SetData(&viewProj, sizeof(glm::mat4));
+		m_FrameInstanceCount = 0;
+		if (m_InstanceStream)
+		{
+			m_InstanceStream->BeginFrame();
+		}
+	}
 
-		m_Batches.clear();
+	void Renderer3DSingleton::EndFrame()
+	{
+		if (m_InstanceStream)
+		{
+			m_InstanceStream->EndFrame();
+		}
+	}
+
+	void Renderer3DSingleton::BeginScene(const ViewData& view)
+	{
+		const glm::mat4& viewMatrix = view.View;
+		m_DepthRow = {-viewMatrix[0][2], -viewMatrix[1][2], -viewMatrix[2][2], -viewMatrix[3][2]};
+		m_ViewportPixels = static_cast<uint64_t>(view.ViewportSize.x) * static_cast<uint64_t>(view.ViewportSize.y);
+
+		ReleaseBatches();
+		m_ResidencyCache.BeginScene();
 	}
 
 	void Renderer3DSingleton::EndScene()
@@ -24,77 +62,384 @@ namespace Snowstorm
 
 	void Renderer3DSingleton::DrawMesh(const glm::mat4& transform, const Ref<Mesh>& mesh, const Ref<Material>& material)
 	{
-		BatchData* batch = nullptr;
-		for (auto& b : m_Batches)
+		// Its shader would read attributes that aren't bound, see Material::AddVertexAttribute
+		if (material->HasExtraAttributes())
 		{
-			if (b.Mesh == mesh && b.Material == material)
+			return;
+		}
+
+		const BatchKey key{mesh.get(), material->GetBatchKey()};
+		if (m_BatchCount == 0 || key != m_LastBatchKey)
+		{
+			const auto [it, inserted] = m_BatchLookup.try_emplace(key, m_BatchCount);
+			if (inserted)
 			{
-				batch = &b;
-				break;
+				// Start a new batch, the mesh is uploaded once it's flushed unless it's already resident
+				if (m_BatchCount == m_Batches.size())
+				{
+					m_Batches.emplace_back();
+				}
+
+				BatchData& newBatch = m_Batches[m_BatchCount++];
+				newBatch.Mesh = mesh;
+				newBatch.Material = material;
 			}
+
+			m_LastBatchKey = key;
+			m_LastBatchIndex = it->second;
 		}
 
-		if (!batch)
+		// Add instance data
+		MeshInstanceData instance;
+		instance.ModelMatrix = transform;
+
+		if (material->UsesMaterialTable())
 		{
-			// Create new batch
-			BatchData newBatch;
-			newBatch.Mesh = mesh;
-			newBatch.Material = material;
-			newBatch.VAO = VertexArray::Create();
-			newBatch.VAO->Bind();
+			instance.MaterialIndex = static_cast<float>(m_MaterialTable.Acquire(material));
+		}
 
-			newBatch.VBO = VertexBuffer::Create(mesh->GetVertices().data(), mesh->GetVertexCount() * sizeof(Vertex));
-			newBatch.IBO = IndexBuffer::Create(mesh->GetIndices().data(), mesh->GetIndexCount());
+		m_Batches[m_LastBatchIndex].Instances.push_back(instance);
 
-			// **Get vertex attributes dynamically from the material**
-			const auto vertexLayout = material->GetVertexLayout();
-			const auto instanceLayout = material->GetInstanceLayout();
+		m_Stats.MeshCount++;
+	}
 
-			newBatch.VBO->SetLayout(vertexLayout);
+	void Renderer3DSingleton::Flush()
+	{
+		const std::span batches(m_Batches.data(), m_BatchCount);
 
-			newBatch.InstanceBuffer = VertexBuffer::Create(1000 * sizeof(MeshInstanceData));
-			newBatch.InstanceBuffer->SetLayout(instanceLayout);
+		uint32_t instanceCount = 0;
+		for (const auto& batch : batches)
+		{
+			instanceCount += static_cast<uint32_t>(batch.Instances.size());
+		}
 
-			newBatch.VAO->AddVertexBuffer(newBatch.VBO);
-			newBatch.VAO->AddVertexBuffer(newBatch.InstanceBuffer);
-			newBatch.VAO->SetIndexBuffer(newBatch.IBO);
+		if (instanceCount == 0)
+		{
+			ReleaseBatches();
+			return;
+		}
 
-			m_Batches.push_back(std::move(newBatch));
-			batch = &m_Batches.back();
+		// Every batch of every scene in the frame gets its own range of the region, so nothing has to be flushed early.
+		// A frame outgrowing the region continues in a larger stream, which the following frames then fit into.
+		if (!m_InstanceStream || m_FrameInstanceCount + instanceCount > m_InstanceStreamCapacity)
+		{
+			m_InstanceStreamCapacity = std::max(InitialInstanceStreamCapacity,
+			                                    std::bit_ceil(m_FrameInstanceCount + instanceCount));
+			m_InstanceStream = StreamingVertexBuffer::Create(m_InstanceStreamCapacity * sizeof(MeshInstanceData));
+			m_InstanceStream->BeginFrame();
+			m_FrameInstanceCount = 0;
+			m_GeometryVertexArray.reset();
 		}
+		m_FrameInstanceCount += instanceCount;
 
-		// Add instance data
-		MeshInstanceData instance;
-		instance.ModelMatrix = transform;
+		// Other renderers bind state directly, so nothing is known to be bound yet
+		m_StateCache.Reset();
 
-		batch->Instances.push_back(instance);
+		// Uploads rebind the index buffer of the bound vertex array, so keep the arena's own one bound meanwhile
+		UpdateGeometryVertexArray();
+		m_StateCache.BindVertexArray(m_GeometryVertexArray);
 
-		if (batch->Instances.size() >= 1000)
+		// Sort by (shader, textures, material, mesh): materials that can share draws end up next to each other and
+		// become a single multi-draw, and consecutive ones share as much state as possible
+		m_DrawOrder.resize(batches.size());
+		std::iota(m_DrawOrder.begin(), m_DrawOrder.end(), 0u);
+		std::ranges::sort(m_DrawOrder, std::less{}, [&](const uint32_t index)
 		{
-			FlushBatch(*batch);
-			batch->Instances.clear();
+			const Material& material = *batches[index].Material;
+			const size_t textureSetKey = material.UsesBindlessTextures() ? 0 : material.GetTextureSetKey();
+			return std::tuple{material.GetShader().get(), textureSetKey, material.GetBatchKey(), batches[index].Mesh.get()};
+		});
+
+		OrderFrontToBack(batches);
+
+		constexpr auto instanceSize = static_cast<uint32_t>(sizeof(MeshInstanceData));
+
+		m_DrawCommands.clear();
+
+		for (const uint32_t index : m_DrawOrder)
+		{
+			const BatchData& batch = batches[index];
+			const auto batchInstanceCount = static_cast<uint32_t>(batch.Instances.size());
+
+			const auto allocation = m_InstanceStream->Allocate(batchInstanceCount * instanceSize, instanceSize);
+			SS_CORE_ASSERT(allocation.Data, "Instance stream region is too small!");
+
+			std::memcpy(allocation.Data, batch.Instances.data(), batchInstanceCount * instanceSize);
+
+			// The stream is shared by all batches, baseInstance selects this batch's range
+			const GeometryAllocation& geometry = m_ResidencyCache.Acquire(batch.Mesh).Geometry;
+			m_DrawCommands.push_back({
+				geometry.IndexCount, batchInstanceCount, geometry.FirstIndex, static_cast<int32_t>(geometry.BaseVertex),
+				allocation.Offset / instanceSize
+			});
+
+			m_Stats.TriangleCount += geometry.IndexCount / 3 * batchInstanceCount;
+		}
+
+		// Acquiring may have grown the arena, which replaces its buffers
+		UpdateGeometryVertexArray();
+		m_StateCache.BindVertexArray(m_GeometryVertexArray);
+
+		const auto commandBytes = static_cast<uint32_t>(m_DrawCommands.size() * sizeof(DrawIndexedIndirectCommand));
+		if (!m_DrawCommandBuffer)
+		{
+			m_DrawCommandBuffer = IndirectBuffer::Create(commandBytes);
+		}
+		m_DrawCommandBuffer->SetData(m_DrawCommands.data(), commandBytes);
+
+		// Parameters of every material drawn, indexed by the instances
+		m_MaterialTable.Upload();
+
+		if (m_DepthPrepass)
+		{
+			// The depth of everything in one multi-draw, the materials then only pass where they are nearest
+			RenderCommand::SetWriteMask(false, true);
+			m_StateCache.BindShader(m_DepthPrepassShader);
+			m_StateCache.BindVertexArray(m_DepthPrepassVertexArray);
+			RenderCommand::DrawIndexedIndirect(m_DepthPrepassVertexArray, m_DrawCommandBuffer,
+			                                   static_cast<uint32_t>(m_DrawCommands.size()));
+			m_Stats.DrawCalls++;
+
+			RenderCommand::SetWriteMask(true, false);
+			RenderCommand::SetDepthFunction(RendererAPI::DepthFunction::LessEqual);
+			m_StateCache.BindVertexArray(m_GeometryVertexArray);
+		}
+
+		const bool countingOverdraw = m_OverdrawCounter && m_OverdrawCounter->Begin();
+		if (countingOverdraw)
+		{
+			m_OverdrawPixels.push_back(m_ViewportPixels);
 		}
+
+		for (uint32_t first = 0; first < m_DrawOrder.size();)
+		{
+			const Ref<Material>& material = batches[m_DrawOrder[first]].Material;
+
+			uint32_t last = first + 1;
+			while (last < m_DrawOrder.size() && material->CanShareDraws(*batches[m_DrawOrder[last]].Material))
+			{
+				last++;
+			}
+
+			material->Bind(m_StateCache);
+			RenderCommand::DrawIndexedIndirect(m_GeometryVertexArray, m_DrawCommandBuffer, last - first,
+			                                   first * static_cast<uint32_t>(sizeof(DrawIndexedIndirectCommand)));
+			m_Stats.DrawCalls++;
+
+			first = last;
+		}
+
+		m_Stats.IndirectDraws += static_cast<uint32_t>(m_DrawCommands.size());
+
+		if (countingOverdraw)
+		{
+			m_OverdrawCounter->End();
+		}
+
+		if (m_DepthPrepass)
+		{
+			RenderCommand::SetWriteMask(true, true);
+			RenderCommand::SetDepthFunction(RendererAPI::DepthFunction::Less);
+		}
+
+		CollectOverdraw();
+
+		ReleaseBatches();
 	}
 
-	void Renderer3DSingleton::Flush()
+	void Renderer3DSingleton::UpdateGeometryVertexArray()
 	{
-		for (auto& batch : m_Batches)
+		const GeometryArena& arena = m_ResidencyCache.GetArena();
+		if (m_GeometryVertexArray && m_GeometryArenaGeneration == arena.GetGeneration())
 		{
-			FlushBatch(batch);
+			return;
 		}
+
+		m_InstanceStream->SetLayout(Material::GetBaseInstanceLayout());
+
+		// Built first, so the full vertex array is the one left bound
+		m_DepthPrepassVertexArray = VertexArray::Create();
+		m_DepthPrepassVertexArray->Bind();
+		m_DepthPrepassVertexArray->AddVertexBuffer(arena.GetPositionBuffer());
+		m_DepthPrepassVertexArray->AddVertexBuffer(m_InstanceStream);
+		m_DepthPrepassVertexArray->SetIndexBuffer(arena.GetIndexBuffer());
+
+		m_GeometryVertexArray = VertexArray::Create();
+		m_GeometryVertexArray->Bind();
+
+		m_GeometryVertexArray->AddVertexBuffer(arena.GetVertexBuffer());
+		m_GeometryVertexArray->AddVertexBuffer(m_InstanceStream);
+		m_GeometryVertexArray->SetIndexBuffer(arena.GetIndexBuffer());
+
+		m_GeometryArenaGeneration = arena.GetGeneration();
+	}
+
+	float Renderer3DSingleton::GetDepth(const MeshInstanceData& instance) const
+	{
+		return dot(m_DepthRow, instance.ModelMatrix[3]);
+	}
+
+	void Renderer3DSingleton::OrderFrontToBack(const std::span<BatchData> batches)
+	{
+		SS_PROFILE_FUNCTION();
+
+		// Instances front to back unless they arrived that way, as they do from RenderQueue3D
+		m_BatchDepths.resize(batches.size());
+		for (uint32_t i = 0; i < batches.size(); i++)
+		{
+			std::vector<MeshInstanceData>& instances = batches[i].Instances;
+
+			float nearest = std::numeric_limits<float>::max();
+			uint64_t previousBucket = 0;
+			bool sorted = true;
+			for (const MeshInstanceData& instance : instances)
+			{
+				const float depth = GetDepth(instance);
+				const uint64_t bucket = GetDepthBucket(depth, BatchDepthShift);
+
+				nearest = std::min(nearest, depth);
+				sorted = sorted && bucket >= previousBucket;
+				previousBucket = bucket;
+			}
+
+			if (!sorted)
+			{
+				SortInstances(instances);
+			}
+
+			m_BatchDepths[i] = nearest;
+		}
+
+		// Batches front to back within every run that shares draws. Without the depth prepass the runs themselves are
+		// ordered by their nearest batch too, trading some state changes for less overdraw; with it every pixel is
+		// shaded once anyway, so runs keep their order by state.
+		m_SortEntries.clear();
+		uint32_t run = 0;
+		for (uint32_t first = 0; first < m_DrawOrder.size(); run++)
+		{
+			const Material& material = *batches[m_DrawOrder[first]].Material;
+			float nearest = m_BatchDepths[m_DrawOrder[first]];
+
+			uint32_t last = first + 1;
+			while (last < m_DrawOrder.size() && material.CanShareDraws(*batches[m_DrawOrder[last]].Material))
+			{
+				nearest = std::min(nearest, m_BatchDepths[m_DrawOrder[last]]);
+				last++;
+			}
+
+			const uint64_t runKey = (m_DepthPrepass ? 0 : GetDepthBucket(nearest, RunDepthShift)) << 48 |
+				static_cast<uint64_t>(run) << 16;
+
+			for (uint32_t i = first; i < last; i++)
+			{
+				const uint32_t index = m_DrawOrder[i];
+				m_SortEntries.push_back({runKey | GetDepthBucket(m_BatchDepths[index], BatchDepthShift), index});
+			}
+
+			first = last;
+		}
+
+		RadixSort(m_SortEntries, m_SortScratch);
+		for (uint32_t i = 0; i < m_SortEntries.size(); i++)
+		{
+			m_DrawOrder[i] = m_SortEntries[i].Value;
+		}
+	}
+
+	void Renderer3DSingleton::SortInstances(std::vector<MeshInstanceData>& instances)
+	{
+		m_SortEntries.resize(instances.size());
+		for (uint32_t i = 0; i < instances.size(); i++)
+		{
+			m_SortEntries[i] = {GetDepthBucket(GetDepth(instances[i]), BatchDepthShift), i};
+		}
+
+		RadixSort(m_SortEntries, m_SortScratch);
+
+		m_InstanceScratch.resize(instances.size());
+		for (uint32_t i = 0; i < instances.size(); i++)
+		{
+			m_InstanceScratch[i] = instances[m_SortEntries[i].Value];
+		}
+
+		// The batch keeps the scratch's storage and the scratch the batch's, both keep their capacity
+		instances.swap(m_InstanceScratch);
 	}
 
-	void Renderer3DSingleton::FlushBatch(BatchData& batch) const
+	void Renderer3DSingleton::SetDepthPrepass(const bool enabled)
 	{
-		if (batch.Instances.empty()) return;
+		if (enabled && !m_DepthPrepassShader)
+		{
+			m_DepthPrepassShader = Shader::Create("assets/shaders/DepthPrepass.glsl");
+		}
+
+		m_DepthPrepass = enabled;
+	}
+
+	void Renderer3DSingleton::SetOverdrawCounting(const bool enabled)
+	{
+		if (enabled == IsOverdrawCounting())
+		{
+			return;
+		}
+
+		m_OverdrawCounter = enabled ? SampleCounter::Create() : nullptr;
+		m_OverdrawPixels.clear();
+	}
 
-		batch.InstanceBuffer->SetData(batch.Instances.data(), batch.Instances.size() * sizeof(MeshInstanceData));
+	void Renderer3DSingleton::CollectOverdraw()
+	{
+		if (!m_OverdrawCounter)
+		{
+			return;
+		}
+
+		while (const std::optional<uint64_t> samples = m_OverdrawCounter->PopResult())
+		{
+			m_Stats.ShadedSamples += *samples;
+			m_Stats.ShadedPixels += m_OverdrawPixels.front();
+			m_OverdrawPixels.pop_front();
+		}
+	}
+
+	void Renderer3DSingleton::ReleaseBatches()
+	{
+		// Drop the references so batches don't keep meshes and materials alive
+		for (uint32_t i = 0; i < m_BatchCount; i++)
+		{
+			m_Batches[i].Mesh.reset();
+			m_Batches[i].Material.reset();
+			m_Batches[i].Instances.clear();
+		}
+
+		m_BatchCount = 0;
+		m_BatchLookup.clear();
+	}
+
+	void Renderer3DSingleton::ResetStats()
+	{
+		m_Stats = {};
+		m_ResidencyCache.ResetStats();
+		m_StateCache.ResetStats();
+		m_MaterialTable.ResetStats();
+	}
+
+	Renderer3DSingleton::Statistics Renderer3DSingleton::GetStats() const
+	{
+		Statistics stats = m_Stats;
 
-		batch.VAO->Bind();
-		batch.Material->Bind();
+		const MeshResidencyCache::Statistics cacheStats = m_ResidencyCache.GetStats();
+		stats.MeshUploads = cacheStats.Uploads;
+		stats.UploadBytes = cacheStats.UploadBytes;
+		stats.EvictedMeshes = cacheStats.Evictions;
+		stats.ResidentMeshes = m_ResidencyCache.GetResidentCount();
+		stats.ResidentBytes = m_ResidencyCache.GetResidentBytes();
 
-		RenderCommand::DrawIndexedInstanced(batch.VAO, batch.Mesh->GetIndexCount(), static_cast<uint32_t>(batch.Instances.size()));
+		const RenderStateCache::Statistics stateStats = m_StateCache.GetStats();
+		stats.StateChanges = stateStats.IssuedStateChanges;
+		stats.SkippedStateChanges = stateStats.SkippedStateChanges;
 
-		batch.Instances.clear();
+		stats.MaterialUploads = m_MaterialTable.GetStats().UploadedRecords;
+		return stats;
 	}
 }
@@ -1,42 +1,165 @@
 #pragma once
 
+#include <deque>
+#include <span>
+
 #include "Camera.hpp"
+#include "IndirectBuffer.hpp"
 #include "Material.hpp"
+#include "MaterialTable.hpp"
 #include "Mesh.hpp"
-#include "UniformBuffer.hpp"
+#include "MeshResidencyCache.hpp"
+#include "OcclusionCuller.hpp"
+#include "RenderQueue3D.hpp"
+#include "RenderStateCache.hpp"
+#include "SampleCounter.hpp"
 #include "VertexArray.hpp"
+#include "ViewSingleton.hpp"
 
 namespace Snowstorm
 {
 	struct MeshInstanceData
 	{
 		glm::mat4 ModelMatrix;
+		float MaterialIndex = 0.0f; // Float since integer attributes are converted anyway, exact up to 2^24
 	};
 
+	// Instances of one mesh recorded in the current scene, the GPU buffers live in the residency cache
+	// Material is the one bound for drawing: instances of other materials can only join the batch if they read all
+	// their parameters from the MaterialTable.
 	struct BatchData
 	{
 		Ref<Mesh> Mesh;
 		Ref<Material> Material;
-		Ref<VertexArray> VAO;
-		Ref<VertexBuffer> VBO;
-		Ref<VertexBuffer> InstanceBuffer;
-		Ref<IndexBuffer> IBO;
 		std::vector<MeshInstanceData> Instances;
 	};
 
+	struct BatchKey
+	{
+		const Mesh* MeshKey = nullptr;
+		const void* StateKey = nullptr; // The shader for materials using bindless textures, otherwise the material
+
+		bool operator==(const BatchKey&) const = default;
+	};
+
+	struct BatchKeyHash
+	{
+		size_t operator()(const BatchKey& key) const
+		{
+			const size_t meshHash = std::hash<const Mesh*>{}(key.MeshKey);
+			return meshHash ^ (std::hash<const void*>{}(key.StateKey) + 0x9e3779b9 + (meshHash << 6) + (meshHash >> 2));
+		}
+	};
+
 	class Renderer3DSingleton final : public Singleton
 	{
 	public:
-		Renderer3DSingleton();
-		void BeginScene(const Camera& camera, const glm::mat4& transform);
+		// Brackets all scenes of a frame, the instance stream moves on to its next region once per frame
+		void BeginFrame();
+		void EndFrame();
+
+		// The view has to be bound at ViewSingleton::Binding until Flush, it is read here to sort and count overdraw
+		void BeginScene(const ViewData& view);
 		void EndScene();
 		void DrawMesh(const glm::mat4& transform, const Ref<Mesh>& mesh, const Ref<Material>& material);
 		void Flush();
 
+		struct Statistics
+		{
+			uint32_t DrawCalls = 0; // Multi-draws, one per run of materials sharing shader and textures
+			uint32_t IndirectDraws = 0; // Draw commands issued by them, one per batch
+			uint32_t MeshCount = 0;
+			uint32_t TriangleCount = 0; // After level of detail selection
+			uint32_t CulledMeshCount = 0; // Meshes dropped by frustum culling before reaching the renderer
+			uint32_t OccludedMeshCount = 0; // Meshes inside the frustum hidden behind occluders
+			uint32_t MeshUploads = 0;
+			uint64_t UploadBytes = 0;
+			uint32_t EvictedMeshes = 0;
+			uint32_t ResidentMeshes = 0;
+			uint64_t ResidentBytes = 0;
+			uint32_t StateChanges = 0; // Shader, texture, vertex array and uniform updates that reached the driver
+			uint32_t SkippedStateChanges = 0; // Ones that matched the current state
+			uint32_t MaterialUploads = 0; // MaterialTable records written because their material changed
+			uint64_t ShadedSamples = 0; // Samples the materials shaded in scenes counted a few frames ago
+			uint64_t ShadedPixels = 0; // Viewport pixels of those scenes
+
+			[[nodiscard]] float GetOverdraw() const
+			{
+				return ShadedPixels ? static_cast<float>(ShadedSamples) / static_cast<float>(ShadedPixels) : 0.0f;
+			}
+		};
+
+		void AddCulledMeshes(const uint32_t count) { m_Stats.CulledMeshCount += count; }
+		void AddOccludedMeshes(const uint32_t count) { m_Stats.OccludedMeshCount += count; }
+
+		void ResetStats();
+		[[nodiscard]] Statistics GetStats() const;
+
+		MeshResidencyCache& GetResidencyCache() { return m_ResidencyCache; }
+
+		// Draws the depth of every batch before the materials, so each pixel is shaded once
+		void SetDepthPrepass(bool enabled);
+		[[nodiscard]] bool IsDepthPrepassEnabled() const { return m_DepthPrepass; }
+
+		// Debug mode counting the samples the materials shade on the GPU, reported as overdraw in the stats
+		void SetOverdrawCounting(bool enabled);
+		[[nodiscard]] bool IsOverdrawCounting() const { return m_OverdrawCounter != nullptr; }
+
+		// Mesh passes run one target at a time, so they share a queue
+		RenderQueue3D& GetQueue() { return m_Queue; }
+		OcclusionCuller& GetOcclusionCuller() { return m_OcclusionCuller; }
+
 	private:
-		void FlushBatch(BatchData& batch) const;
+		void ReleaseBatches();
+		void UpdateGeometryVertexArray();
+
+		[[nodiscard]] float GetDepth(const MeshInstanceData& instance) const;
+		void OrderFrontToBack(std::span<BatchData> batches);
+		void SortInstances(std::vector<MeshInstanceData>& instances);
+		void CollectOverdraw();
+
+		MeshResidencyCache m_ResidencyCache;
+		RenderStateCache m_StateCache;
+		MaterialTable m_MaterialTable;
+		RenderQueue3D m_Queue;
+		OcclusionCuller m_OcclusionCuller;
+
+		// Instance data of all batches, written into a new region every scene
+		Ref<StreamingVertexBuffer> m_InstanceStream;
+		uint32_t m_InstanceStreamCapacity = 0;
+		uint32_t m_FrameInstanceCount = 0; // Written to the current region so far
 
-		Ref<UniformBuffer> m_CameraUBO;
+		// Reads every resident mesh and the instance stream, rebuilt when either is replaced
+		Ref<VertexArray> m_GeometryVertexArray;
+		Ref<VertexArray> m_DepthPrepassVertexArray; // Positions only
+		uint32_t m_GeometryArenaGeneration = 0;
+
+		bool m_DepthPrepass = false;
+		Ref<Shader> m_DepthPrepassShader;
+
+		Ref<SampleCounter> m_OverdrawCounter; // Only while counting
+		std::deque<uint64_t> m_OverdrawPixels; // Viewport pixels of every counted scene still in flight
+		uint64_t m_ViewportPixels = 0;
+
+		std::vector<uint32_t> m_DrawOrder; // Batch indices grouped by shader and textures
+		std::vector<float> m_BatchDepths; // Nearest instance of every batch
+		std::vector<RadixSortEntry> m_SortEntries;
+		std::vector<RadixSortEntry> m_SortScratch;
+		std::vector<MeshInstanceData> m_InstanceScratch;
+		glm::vec4 m_DepthRow{0.0f}; // Dotted with a position, gives its distance along the view direction
+		std::vector<DrawIndexedIndirectCommand> m_DrawCommands;
+		Ref<IndirectBuffer> m_DrawCommandBuffer;
+
+		// Batches are reused across scenes so their instance storage keeps its capacity, only the first
+		// m_BatchCount are part of the current scene
 		std::vector<BatchData> m_Batches;
+		uint32_t m_BatchCount = 0;
+		std::unordered_map<BatchKey, uint32_t, BatchKeyHash> m_BatchLookup;
+
+		// Sorted submissions draw a batch's instances in a row, so the last batch is checked before the lookup
+		BatchKey m_LastBatchKey;
+		uint32_t m_LastBatchIndex = 0;
+
+		Statistics m_Stats;
 	};
 }
@@ -2,10 +2,19 @@
 
 #include <glm/glm.hpp>
 
+#include "IndirectBuffer.hpp"
 #include "VertexArray.hpp"
 
 namespace Snowstorm
 {
+	// Limits and optional features of the active graphics backend, filled in by RendererAPI::Init
+	struct RendererCapabilities
+	{
+		uint32_t MaxTextureSlots = 16; // Texture units a fragment shader can sample from
+		bool BindlessTextures = false; // Including sampling with handles that differ within a draw
+		uint32_t UniformBufferAlignment = 256; // Offsets uniform buffer ranges can be bound at are multiples of this
+	};
+
 	class RendererAPI
 	{
 	public:
@@ -25,17 +34,37 @@ namespace Snowstorm
 			Vulkan = 2
 		};
 
+		enum class DepthFunction : uint8_t
+		{
+			Less,
+			LessEqual // Lets a pass redraw the depth a prepass already wrote
+		};
+
 		virtual void Init() = 0;
 
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
 		virtual void SetClearColor(const glm::vec4& color) = 0;
 		virtual void Clear() = 0;
 
-		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
-		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount) = 0;
+		virtual void SetDepthFunction(DepthFunction function) = 0;
+		// Disabled writes keep testing, so a depth-only pass turns color off and the pass after it depth
+		virtual void SetWriteMask(bool color, bool depth) = 0;
+
+		// baseVertex is added to every index, baseInstance offsets instanced attributes (both in elements)
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t baseVertex = 0) = 0;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount,
+		                                  uint32_t baseInstance = 0, uint32_t baseVertex = 0) = 0;
+		// Issues drawCount DrawIndexedIndirectCommands read from commands, starting offset bytes in
+		virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& commands,
+		                                 uint32_t drawCount, uint32_t offset = 0) = 0;
+
+		[[nodiscard]] const RendererCapabilities& GetCapabilities() const { return m_Capabilities; }
 
 		static API GetAPI() { return s_API; }
 
+	protected:
+		RendererCapabilities m_Capabilities;
+
 	private:
 		inline static auto s_API = API::OpenGL;
 	};
@@ -0,0 +1,26 @@
+#include "SampleCounter.hpp"
+
+#include "Renderer2D.hpp"
+
+#include "Platform/OpenGL/OpenGLSampleCounter.hpp"
+
+namespace Snowstorm
+{
+	std::shared_ptr<SampleCounter> SampleCounter::Create()
+	{
+		switch (Renderer2D::GetAPI())
+		{
+		case RendererAPI::API::None:
+			SS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+			return nullptr;
+		case RendererAPI::API::OpenGL:
+			return CreateRef<OpenGLSampleCounter>();
+		case RendererAPI::API::Vulkan:
+			SS_CORE_ASSERT(false, "VulkanSampleCounter is not yet supported!");
+			return nullptr;
+		}
+
+		SS_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+}
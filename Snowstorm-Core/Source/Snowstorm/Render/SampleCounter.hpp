@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace Snowstorm
+{
+	// Counts on the GPU how many samples pass the depth test between Begin and End
+	// Results arrive a few frames later and are read without waiting for the GPU, in the order they were begun.
+	class SampleCounter
+	{
+	public:
+		virtual ~SampleCounter() = default;
+
+		// Returns false when every query is still in flight, nothing is counted until the matching End then
+		virtual bool Begin() = 0;
+		virtual void End() = 0;
+
+		// Result of the oldest finished query, if the GPU has finished it yet
+		virtual std::optional<uint64_t> PopResult() = 0;
+
+		static std::shared_ptr<SampleCounter> Create();
+	};
+}
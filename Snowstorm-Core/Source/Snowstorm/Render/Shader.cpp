@@ -5,7 +5,9 @@
 #include "Platform/OpenGL/OpenGLShader.h"
 #include "Platform/Vulkan/VulkanShader.h"
 
-#include <filesystem>
+#include <algorithm>
+
+#include "Snowstorm/Utility/FileSystem.hpp"
 
 namespace Snowstorm
 {
@@ -26,6 +28,57 @@ namespace Snowstorm
 		return nullptr;
 	}
 
+	const ShaderReflection::Uniform* ShaderReflection::FindUniform(const std::string_view name) const
+	{
+		const auto it = std::ranges::find(Uniforms, name, &Uniform::Name);
+		return it != Uniforms.end() ? &*it : nullptr;
+	}
+
+	const ShaderReflection::Attribute* ShaderReflection::FindAttribute(const std::string_view name) const
+	{
+		const auto it = std::ranges::find(Attributes, name, &Attribute::Name);
+		return it != Attributes.end() ? &*it : nullptr;
+	}
+
+	UniformHandle Shader::GetUniformHandle(const std::string& name)
+	{
+		const auto [it, inserted] = m_UniformLookup.try_emplace(name, static_cast<uint32_t>(m_Uniforms.size()));
+		if (inserted)
+		{
+			BoundUniform& uniform = m_Uniforms.emplace_back();
+			uniform.Slot.Name = name;
+			ResolveUniform(uniform);
+		}
+
+		return {it->second};
+	}
+
+	void Shader::SetReflection(ShaderReflection reflection)
+	{
+		m_Reflection = std::move(reflection);
+		m_HasReflection = true;
+
+		// A new program starts with default values, so nothing uploaded before is current anymore
+		for (BoundUniform& uniform : m_Uniforms)
+		{
+			ResolveUniform(uniform);
+			uniform.Value.reset();
+		}
+	}
+
+	void Shader::ResolveUniform(BoundUniform& uniform) const
+	{
+		if (!m_HasReflection)
+		{
+			uniform.Active = true;
+			return;
+		}
+
+		const ShaderReflection::Uniform* reflected = m_Reflection.FindUniform(uniform.Slot.Name);
+		uniform.Slot.Location = reflected ? reflected->Location : -1;
+		uniform.Active = reflected != nullptr;
+	}
+
 	void ShaderLibrarySingleton::Add(const Ref<Shader>& shader, const std::string& filepath)
 	{
 		SS_CORE_ASSERT(!Exists(filepath), "Shader already exists!");
@@ -42,8 +95,6 @@ namespace Snowstorm
 		auto shader = Shader::Create(filepath);
 		Add(shader, filepath);
 
-		m_LastModifications[filepath] = std::filesystem::last_write_time(filepath);
-
 		return shader;
 	}
 
@@ -58,14 +109,32 @@ namespace Snowstorm
 		return m_Shaders.contains(filepath);
 	}
 
-	void ShaderLibrarySingleton::ReloadAll()
+	bool ShaderLibrarySingleton::Reload(const std::string& path)
 	{
-		for (const auto& [filepath, lastModified] : m_LastModifications)
+		bool reloaded = false;
+		for (const auto& [filepath, shader] : m_Shaders)
 		{
-			if (std::filesystem::last_write_time(filepath) > lastModified)
+			if (IsSameFile(filepath, path))
 			{
-				Get(filepath)->Recompile();
+				shader->Recompile();
+				reloaded = true;
 			}
 		}
+
+		return reloaded;
+	}
+
+	std::vector<ShaderLibrarySingleton::CompletedReload> ShaderLibrarySingleton::CollectReloads()
+	{
+		std::vector<CompletedReload> reloads;
+		for (const auto& [filepath, shader] : m_Shaders)
+		{
+			if (std::optional<ShaderCompileResult> result = shader->PollRecompile())
+			{
+				reloads.push_back({filepath, std::move(*result)});
+			}
+		}
+
+		return reloads;
 	}
 }
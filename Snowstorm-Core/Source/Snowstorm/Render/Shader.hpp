@@ -1,16 +1,71 @@
 #pragma once
 
+#include <optional>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
 #include <Snowstorm/Utility/Math.hpp>
 
 #include <glm/glm.hpp>
 
+#include "Buffer.hpp"
+
 #include "Snowstorm/ECS/Singleton.hpp"
 #include <Snowstorm/Core/Base.h>
 
 namespace Snowstorm
 {
+	// Compact reference to a uniform of one shader, see Shader::GetUniformHandle
+	struct UniformHandle
+	{
+		static constexpr uint32_t Invalid = ~0u;
+
+		uint32_t Index = Invalid;
+
+		[[nodiscard]] bool IsValid() const { return Index != Invalid; }
+	};
+
+	// Interface of a linked shader program, as reported by the graphics API
+	struct ShaderReflection
+	{
+		struct Uniform
+		{
+			std::string Name; // Arrays are named without their "[0]" suffix
+			ShaderDataType Type = ShaderDataType::None;
+			int32_t Location = -1;
+			uint32_t ArraySize = 1;
+			bool Sampler = false; // Type is Int for samplers
+		};
+
+		struct Block
+		{
+			std::string Name;
+			uint32_t Binding = 0;
+			uint32_t Size = 0; // In bytes
+		};
+
+		struct Attribute
+		{
+			std::string Name;
+			ShaderDataType Type = ShaderDataType::None;
+			int32_t Location = -1;
+		};
+
+		std::vector<Uniform> Uniforms; // Default block only, block members are covered by the blocks
+		std::vector<Block> UniformBlocks;
+		std::vector<Block> StorageBlocks;
+		std::vector<Attribute> Attributes;
+
+		[[nodiscard]] const Uniform* FindUniform(std::string_view name) const;
+		[[nodiscard]] const Attribute* FindAttribute(std::string_view name) const;
+	};
+
+	struct ShaderCompileResult
+	{
+		bool Succeeded = false;
+		std::string Log; // Compiler and linker output when it failed
+	};
+
 	class Shader
 	{
 	public:
@@ -28,49 +83,90 @@ namespace Snowstorm
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
-		// Public API with unified caching
+		// Hashes the name once, the handle then addresses the uniform directly and stays valid across recompiles.
+		// Uniforms the shader doesn't use still get a handle, setting them does nothing.
+		[[nodiscard]] UniformHandle GetUniformHandle(const std::string& name);
+
+		// Uploads the value unless the uniform already holds it, returns whether it was uploaded
 		template <typename T>
-		void SetUniform(const std::string& name, const T& value)
+		bool SetUniform(const UniformHandle handle, const T& value)
 		{
-			const auto it = m_UniformCache.find(name);
+			SS_CORE_ASSERT(handle.Index < m_Uniforms.size(), "Invalid uniform handle!");
+			BoundUniform& uniform = m_Uniforms[handle.Index];
 
-			// Check if the value is already cached and matches the new value
-			if (it != m_UniformCache.end() && std::holds_alternative<T>(it->second) &&
-				isEqual(std::get<T>(it->second), value))
+			if (!uniform.Active || (uniform.Value && std::holds_alternative<T>(*uniform.Value) &&
+				isEqual(std::get<T>(*uniform.Value), value)))
 			{
-				return;
+				return false;
 			}
 
-			// Update the cache and upload the uniform to the GPU
-			m_UniformCache[name] = value;
-			UploadUniform(name, value);
+			uniform.Value = value;
+			UploadUniform(uniform.Slot, value);
+			return true;
 		}
 
+		// Looks the handle up by name on every call, keep the handle around on hot paths
+		template <typename T>
+		bool SetUniform(const std::string& name, const T& value)
+		{
+			return SetUniform(GetUniformHandle(name), value);
+		}
+
+		[[nodiscard]] const ShaderReflection& GetReflection() const { return m_Reflection; }
+		// False for backends that don't reflect their shaders yet, GetReflection is empty then
+		[[nodiscard]] bool HasReflection() const { return m_HasReflection; }
+
 		[[nodiscard]] virtual const std::string& GetPath() const = 0;
 
 		static Ref<Shader> Create(const std::string& filepath);
 
+		// Starts compiling the shader's file again, the current program keeps being used until PollRecompile swaps
+		// the new one in. Starting again before that supersedes the recompile in flight.
 		void Recompile()
 		{
 			Compile();
-			m_UniformCache.clear();
 		}
 
+		// Returns the outcome once a recompile finished, the new program is in use from then on if it succeeded
+		[[nodiscard]] virtual std::optional<ShaderCompileResult> PollRecompile() = 0;
+
 	protected:
+		// What a backend needs to address a uniform
+		struct UniformSlot
+		{
+			std::string Name;
+			int32_t Location = -1;
+		};
+
 		// Virtual methods for GPU upload
-		virtual void UploadUniform(const std::string& name, int value) = 0;
-		virtual void UploadUniform(const std::string& name, float value) = 0;
-		virtual void UploadUniform(const std::string& name, const glm::vec2& value) = 0;
-		virtual void UploadUniform(const std::string& name, const glm::vec3& value) = 0;
-		virtual void UploadUniform(const std::string& name, const glm::vec4& value) = 0;
-		virtual void UploadUniform(const std::string& name, const glm::mat4& value) = 0;
-		virtual void UploadUniform(const std::string& name, const std::vector<int>& values) = 0;
+		virtual void UploadUniform(const UniformSlot& uniform, int value) = 0;
+		virtual void UploadUniform(const UniformSlot& uniform, float value) = 0;
+		virtual void UploadUniform(const UniformSlot& uniform, const glm::vec2& value) = 0;
+		virtual void UploadUniform(const UniformSlot& uniform, const glm::vec3& value) = 0;
+		virtual void UploadUniform(const UniformSlot& uniform, const glm::vec4& value) = 0;
+		virtual void UploadUniform(const UniformSlot& uniform, const glm::mat4& value) = 0;
+		virtual void UploadUniform(const UniformSlot& uniform, const std::vector<int>& values) = 0;
 
 		virtual void Compile() = 0;
 
+		// Called by backends after linking, resolves every handle against the new program
+		void SetReflection(ShaderReflection reflection);
+
 	private:
-		// Single cache for all uniform types
-		std::unordered_map<std::string, UniformValue> m_UniformCache;
+		struct BoundUniform
+		{
+			UniformSlot Slot;
+			bool Active = false;
+			std::optional<UniformValue> Value; // Last uploaded value
+		};
+
+		void ResolveUniform(BoundUniform& uniform) const;
+
+		ShaderReflection m_Reflection;
+		bool m_HasReflection = false;
+
+		std::vector<BoundUniform> m_Uniforms; // Indexed by UniformHandle::Index
+		std::unordered_map<std::string, uint32_t> m_UniformLookup;
 	};
 
 	class ShaderLibrarySingleton final : public Singleton
@@ -81,12 +177,21 @@ namespace Snowstorm
 
 		[[nodiscard]] bool Exists(const std::string& filepath) const;
 
-		void ReloadAll();
+		// Starts recompiling the shaders loaded from the file at path, returns whether there were any
+		bool Reload(const std::string& path);
+
+		struct CompletedReload
+		{
+			std::string Filepath;
+			ShaderCompileResult Result;
+		};
+
+		// Recompiles that finished since the last call
+		[[nodiscard]] std::vector<CompletedReload> CollectReloads();
 
 	private:
 		void Add(const Ref<Shader>& shader, const std::string& filepath);
 
 		std::unordered_map<std::string, Ref<Shader>> m_Shaders;
-		std::unordered_map<std::string, std::filesystem::file_time_type> m_LastModifications;
 	};
 }
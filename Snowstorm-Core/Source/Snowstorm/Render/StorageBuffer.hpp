@@ -0,0 +1,22 @@
+#pragma once
+
+#include <memory>
+
+namespace Snowstorm
+{
+	class StorageBuffer
+	{
+	public:
+		virtual ~StorageBuffer() = default;
+
+		// Grows the buffer if the data doesn't fit, growing discards the previous contents
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+		// Binds the buffer to the binding point it was created with
+		virtual void Bind() const = 0;
+
+		[[nodiscard]] virtual uint32_t GetRendererID() const = 0;
+
+		static std::shared_ptr<StorageBuffer> Create(uint32_t size, uint32_t binding);
+	};
+}
@@ -5,8 +5,33 @@
 #include "Platform/OpenGL/OpenGLTexture.h"
 #include "Platform/Vulkan/VulkanTexture.h"
 
+#include "Snowstorm/Utility/FileSystem.hpp"
+
 namespace Snowstorm
 {
+	namespace
+	{
+		// Every texture created from a file, so changes to the file can reach it without an owner keeping track
+		std::vector<std::weak_ptr<Texture2D>> s_FileTextures;
+
+		Ref<Texture2D> TrackFileTexture(Ref<Texture2D> texture)
+		{
+			std::erase_if(s_FileTextures, [](const std::weak_ptr<Texture2D>& tracked) { return tracked.expired(); });
+			s_FileTextures.push_back(texture);
+			return texture;
+		}
+	}
+
+	uint64_t Texture::GetBindlessHandle() const
+	{
+		return 0;
+	}
+
+	void Texture::SetDistanceField(const bool distanceField)
+	{
+		m_DistanceField = distanceField;
+	}
+
 	Ref<Texture2D> Texture2D::Create(uint32_t width, uint32_t height)
 	{
 		switch (Renderer2D::GetAPI())
@@ -32,12 +57,31 @@ namespace Snowstorm
 			SS_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
 			return nullptr;
 		case RendererAPI::API::OpenGL:
-			return CreateRef<OpenGLTexture2D>(path);
+			return TrackFileTexture(CreateRef<OpenGLTexture2D>(path));
 		case RendererAPI::API::Vulkan:
-			return CreateRef<VulkanTexture2D>(path);
+			return TrackFileTexture(CreateRef<VulkanTexture2D>(path));
 		}
 
 		SS_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
+
+	bool Texture2D::Reload()
+	{
+		return false;
+	}
+
+	uint32_t Texture2D::ReloadFile(const std::string& path)
+	{
+		uint32_t reloaded = 0;
+		for (const std::weak_ptr<Texture2D>& tracked : s_FileTextures)
+		{
+			if (const Ref<Texture2D> texture = tracked.lock(); texture && IsSameFile(texture->GetPath(), path))
+			{
+				reloaded += texture->Reload() ? 1 : 0;
+			}
+		}
+
+		return reloaded;
+	}
 }
@@ -22,11 +22,27 @@ namespace Snowstorm
 
 		[[nodiscard]] virtual uint32_t GetRendererID() const = 0;
 
+		// File the texture was loaded from, empty for textures created in memory
+		[[nodiscard]] virtual const std::string& GetPath() const = 0;
+
+		// Whether any texel is less than fully opaque, in which case the texture has to be blended
+		[[nodiscard]] virtual bool HasAlphaChannel() const = 0;
+
 		virtual void SetData(void* data, uint32_t size) = 0;
 
 		virtual void Bind(uint32_t slot = 0) const = 0;
 
+		// Resident handle for bindless sampling, 0 if the backend doesn't support it (render thread only)
+		[[nodiscard]] virtual uint64_t GetBindlessHandle() const;
+
+		// Marks the alpha channel as a signed distance field (edge at 0.5) that Renderer2D thresholds when drawing
+		virtual void SetDistanceField(bool distanceField);
+		[[nodiscard]] bool IsDistanceField() const { return m_DistanceField; }
+
 		virtual bool operator==(const Texture& other) const = 0;
+
+	private:
+		bool m_DistanceField = false;
 	};
 
 	class Texture2D : public Texture
@@ -34,6 +50,13 @@ namespace Snowstorm
 	public:
 		static Ref<Texture2D> Create(uint32_t width, uint32_t height);
 		static Ref<Texture2D> Create(const std::string& path);
+
+		// Reads the texture's file again, returns false if that isn't possible without recreating the texture (the
+		// image changed size or format, or the backend can't) and keeps the previous contents then
+		virtual bool Reload();
+
+		// Reloads every texture still alive that was created from the file at path, returns how many were updated
+		static uint32_t ReloadFile(const std::string& path);
 	};
 
 }
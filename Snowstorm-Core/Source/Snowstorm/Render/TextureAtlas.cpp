@@ -0,0 +1,499 @@
+#include "pch.h"
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+#include <stb_image.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace Snowstorm
+{
+	namespace
+	{
+		constexpr uint32_t BytesPerPixel = 4;
+
+		struct PackRect
+		{
+			uint32_t X = 0;
+			uint32_t Y = 0;
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+
+			[[nodiscard]] bool Contains(const PackRect& other) const
+			{
+				return other.X >= X && other.Y >= Y &&
+					other.X + other.Width <= X + Width && other.Y + other.Height <= Y + Height;
+			}
+
+			[[nodiscard]] bool Overlaps(const PackRect& other) const
+			{
+				return other.X < X + Width && other.X + other.Width > X &&
+					other.Y < Y + Height && other.Y + other.Height > Y;
+			}
+		};
+
+		// One page worth of free space, kept as the list of maximal free rectangles
+		class MaxRectsBin
+		{
+		public:
+			explicit MaxRectsBin(const uint32_t size)
+			{
+				m_FreeRects.push_back({0, 0, size, size});
+			}
+
+			// Places a width x height rectangle where it leaves the shortest leftover side
+			bool Insert(const uint32_t width, const uint32_t height, PackRect& outRect)
+			{
+				uint32_t bestShortSide = UINT32_MAX;
+				uint32_t bestLongSide = UINT32_MAX;
+				const PackRect* best = nullptr;
+
+				for (const PackRect& freeRect : m_FreeRects)
+				{
+					if (width > freeRect.Width || height > freeRect.Height)
+					{
+						continue;
+					}
+
+					const uint32_t leftoverX = freeRect.Width - width;
+					const uint32_t leftoverY = freeRect.Height - height;
+					const uint32_t shortSide = std::min(leftoverX, leftoverY);
+					const uint32_t longSide = std::max(leftoverX, leftoverY);
+
+					if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+					{
+						best = &freeRect;
+						bestShortSide = shortSide;
+						bestLongSide = longSide;
+					}
+				}
+
+				if (!best)
+				{
+					return false;
+				}
+
+				outRect = {best->X, best->Y, width, height};
+				SplitFreeRects(outRect);
+				PruneFreeRects();
+
+				m_UsedWidth = std::max(m_UsedWidth, outRect.X + outRect.Width);
+				m_UsedHeight = std::max(m_UsedHeight, outRect.Y + outRect.Height);
+
+				return true;
+			}
+
+			[[nodiscard]] uint32_t GetUsedWidth() const { return m_UsedWidth; }
+			[[nodiscard]] uint32_t GetUsedHeight() const { return m_UsedHeight; }
+
+		private:
+			// Replaces every free rectangle the placed one overlaps with the (up to four) maximal rectangles around it
+			void SplitFreeRects(const PackRect& used)
+			{
+				std::vector<PackRect> split;
+
+				for (size_t i = 0; i < m_FreeRects.size();)
+				{
+					const PackRect freeRect = m_FreeRects[i];
+					if (!freeRect.Overlaps(used))
+					{
+						i++;
+						continue;
+					}
+
+					if (used.X > freeRect.X)
+					{
+						split.push_back({freeRect.X, freeRect.Y, used.X - freeRect.X, freeRect.Height});
+					}
+					if (used.X + used.Width < freeRect.X + freeRect.Width)
+					{
+						split.push_back({
+							used.X + used.Width, freeRect.Y, freeRect.X + freeRect.Width - (used.X + used.Width), freeRect.Height
+						});
+					}
+					if (used.Y > freeRect.Y)
+					{
+						split.push_back({freeRect.X, freeRect.Y, freeRect.Width, used.Y - freeRect.Y});
+					}
+					if (used.Y + used.Height < freeRect.Y + freeRect.Height)
+					{
+						split.push_back({
+							freeRect.X, used.Y + used.Height, freeRect.Width, freeRect.Y + freeRect.Height - (used.Y + used.Height)
+						});
+					}
+
+					m_FreeRects[i] = m_FreeRects.back();
+					m_FreeRects.pop_back();
+				}
+
+				m_FreeRects.insert(m_FreeRects.end(), split.begin(), split.end());
+			}
+
+			// Drops free rectangles that are fully covered by another one
+			void PruneFreeRects()
+			{
+				for (size_t i = 0; i < m_FreeRects.size(); i++)
+				{
+					for (size_t j = i + 1; j < m_FreeRects.size();)
+					{
+						if (m_FreeRects[i].Contains(m_FreeRects[j]))
+						{
+							m_FreeRects.erase(m_FreeRects.begin() + static_cast<ptrdiff_t>(j));
+						}
+						else if (m_FreeRects[j].Contains(m_FreeRects[i]))
+						{
+							m_FreeRects.erase(m_FreeRects.begin() + static_cast<ptrdiff_t>(i));
+							i--;
+							break;
+						}
+						else
+						{
+							j++;
+						}
+					}
+				}
+			}
+
+			std::vector<PackRect> m_FreeRects;
+			uint32_t m_UsedWidth = 0;
+			uint32_t m_UsedHeight = 0;
+		};
+
+		glm::vec4 GetUVRect(const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height,
+		                    const uint32_t pageWidth, const uint32_t pageHeight)
+		{
+			const auto w = static_cast<float>(pageWidth);
+			const auto h = static_cast<float>(pageHeight);
+
+			return {
+				static_cast<float>(x) / w, static_cast<float>(y) / h,
+				static_cast<float>(x + width) / w, static_cast<float>(y + height) / h
+			};
+		}
+
+		std::string GetPageFileName(const std::filesystem::path& atlasPath, const uint32_t page)
+		{
+			return atlasPath.stem().string() + "_" + std::to_string(page) + ".png";
+		}
+	}
+
+	TextureAtlas::TextureAtlas(std::vector<Ref<Texture2D>> pages, std::unordered_map<std::string, Region> regions)
+		: m_Pages(std::move(pages)), m_Regions(std::move(regions))
+	{
+	}
+
+	const TextureAtlas::Region* TextureAtlas::Find(const std::string& name) const
+	{
+		const auto it = m_Regions.find(name);
+		return it != m_Regions.end() ? &it->second : nullptr;
+	}
+
+	Ref<SubTexture2D> TextureAtlas::GetSubTexture(const std::string& name) const
+	{
+		const Region* region = Find(name);
+		if (!region)
+		{
+			SS_CORE_WARN("Texture atlas has no region named '{0}'", name);
+			return nullptr;
+		}
+
+		return CreateRef<SubTexture2D>(m_Pages[region->Page], glm::vec2{region->UVRect.x, region->UVRect.y},
+		                               glm::vec2{region->UVRect.z, region->UVRect.w});
+	}
+
+	bool TextureAtlas::Remap(Ref<Texture2D>& texture, glm::vec4& uvRect) const
+	{
+		if (!texture || texture->GetPath().empty())
+		{
+			return false;
+		}
+
+		const Region* region = Find(texture->GetPath());
+		if (!region)
+		{
+			return false;
+		}
+
+		const glm::vec2 min{region->UVRect.x, region->UVRect.y};
+		const glm::vec2 max{region->UVRect.z, region->UVRect.w};
+
+		texture = m_Pages[region->Page];
+		uvRect = {mix(min, max, glm::vec2{uvRect.x, uvRect.y}), mix(min, max, glm::vec2{uvRect.z, uvRect.w})};
+
+		return true;
+	}
+
+	Ref<TextureAtlas> TextureAtlas::Load(const std::string& atlasPath)
+	{
+		SS_PROFILE_FUNCTION();
+
+		std::ifstream in(atlasPath);
+		if (!in)
+		{
+			SS_CORE_ERROR("Could not open file '{0}'", atlasPath);
+			return nullptr;
+		}
+
+		const std::filesystem::path directory = std::filesystem::path(atlasPath).parent_path();
+
+		std::vector<Ref<Texture2D>> pages;
+		std::unordered_map<std::string, Region> regions;
+
+		std::string line;
+		while (std::getline(in, line))
+		{
+			std::istringstream stream(line);
+			std::string type;
+			stream >> type;
+
+			if (type == "page")
+			{
+				std::string fileName;
+				stream >> fileName;
+				pages.push_back(Texture2D::Create((directory / fileName).string()));
+			}
+			else if (type == "region")
+			{
+				uint32_t page = 0, x = 0, y = 0, width = 0, height = 0;
+				stream >> page >> x >> y >> width >> height >> std::ws;
+
+				std::string name;
+				std::getline(stream, name);
+
+				if (stream.fail() || page >= pages.size())
+				{
+					SS_CORE_ERROR("Invalid region '{0}' in texture atlas '{1}'", line, atlasPath);
+					return nullptr;
+				}
+
+				regions[name] = {page, GetUVRect(x, y, width, height, pages[page]->GetWidth(), pages[page]->GetHeight())};
+			}
+		}
+
+		return CreateRef<TextureAtlas>(std::move(pages), std::move(regions));
+	}
+
+	void TextureAtlasBuilder::AddImage(const std::string& name, const uint8_t* pixels, const uint32_t width,
+	                                   const uint32_t height)
+	{
+		SS_CORE_ASSERT(width > 0 && height > 0, "Atlas images can't be empty!");
+
+		Image& image = m_Images.emplace_back();
+		image.Name = name;
+		image.Width = width;
+		image.Height = height;
+		image.Pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * BytesPerPixel);
+	}
+
+	bool TextureAtlasBuilder::AddImage(const std::string& path)
+	{
+		SS_PROFILE_FUNCTION();
+
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load(1); // Same orientation as Texture2D
+		stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, BytesPerPixel);
+		if (!data)
+		{
+			SS_CORE_ERROR("Could not load image '{0}'", path);
+			return false;
+		}
+
+		AddImage(path, data, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+		stbi_image_free(data);
+
+		return true;
+	}
+
+	bool TextureAtlasBuilder::Pack(const uint32_t maxPageSize, const uint32_t padding)
+	{
+		SS_PROFILE_FUNCTION();
+
+		m_Placements.assign(m_Images.size(), {});
+		m_Pages.clear();
+
+		// Placing large images first leaves the small ones to fill the gaps
+		std::vector<uint32_t> order(m_Images.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::ranges::sort(order, [&](const uint32_t a, const uint32_t b)
+		{
+			const Image& imageA = m_Images[a];
+			const Image& imageB = m_Images[b];
+
+			const uint32_t sideA = std::max(imageA.Width, imageA.Height);
+			const uint32_t sideB = std::max(imageB.Width, imageB.Height);
+			if (sideA != sideB)
+			{
+				return sideA > sideB;
+			}
+
+			return imageA.Width * imageA.Height > imageB.Width * imageB.Height;
+		});
+
+		std::vector<MaxRectsBin> bins;
+		for (const uint32_t index : order)
+		{
+			const Image& image = m_Images[index];
+			const uint32_t paddedWidth = image.Width + padding * 2;
+			const uint32_t paddedHeight = image.Height + padding * 2;
+
+			if (paddedWidth > maxPageSize || paddedHeight > maxPageSize)
+			{
+				SS_CORE_ERROR("Image '{0}' ({1}x{2}) doesn't fit on a {3}x{3} atlas page", image.Name, image.Width,
+				              image.Height, maxPageSize);
+				return false;
+			}
+
+			// First page with room, or a new one
+			PackRect rect;
+			uint32_t page = 0;
+			while (page < bins.size() && !bins[page].Insert(paddedWidth, paddedHeight, rect))
+			{
+				page++;
+			}
+
+			if (page == bins.size())
+			{
+				bins.emplace_back(maxPageSize).Insert(paddedWidth, paddedHeight, rect);
+			}
+
+			m_Placements[index] = {page, rect.X + padding, rect.Y + padding};
+		}
+
+		// Shrink every page to the smallest power of two that holds its images
+		m_Pages.resize(bins.size());
+		for (size_t i = 0; i < bins.size(); i++)
+		{
+			Page& page = m_Pages[i];
+			page.Width = std::bit_ceil(bins[i].GetUsedWidth());
+			page.Height = std::bit_ceil(bins[i].GetUsedHeight());
+			page.Pixels.assign(static_cast<size_t>(page.Width) * page.Height * BytesPerPixel, 0);
+		}
+
+		// Copy the images in, extruding their edge pixels into the padding
+		for (size_t i = 0; i < m_Images.size(); i++)
+		{
+			const Image& image = m_Images[i];
+			const Placement& placement = m_Placements[i];
+			Page& page = m_Pages[placement.Page];
+
+			const auto paddedWidth = static_cast<int32_t>(image.Width + padding * 2);
+			const auto paddedHeight = static_cast<int32_t>(image.Height + padding * 2);
+
+			for (int32_t y = 0; y < paddedHeight; y++)
+			{
+				const int32_t sourceY = std::clamp(y - static_cast<int32_t>(padding), 0, static_cast<int32_t>(image.Height) - 1);
+				const uint32_t pageY = placement.Y - padding + y;
+
+				for (int32_t x = 0; x < paddedWidth; x++)
+				{
+					const int32_t sourceX = std::clamp(x - static_cast<int32_t>(padding), 0, static_cast<int32_t>(image.Width) - 1);
+					const uint32_t pageX = placement.X - padding + x;
+
+					std::memcpy(&page.Pixels[(static_cast<size_t>(pageY) * page.Width + pageX) * BytesPerPixel],
+					            &image.Pixels[(static_cast<size_t>(sourceY) * image.Width + sourceX) * BytesPerPixel],
+					            BytesPerPixel);
+				}
+			}
+		}
+
+		SS_CORE_INFO("Packed {0} images into {1} atlas page(s)", m_Images.size(), m_Pages.size());
+
+		return true;
+	}
+
+	Ref<TextureAtlas> TextureAtlasBuilder::CreateAtlas() const
+	{
+		SS_PROFILE_FUNCTION();
+
+		std::vector<Ref<Texture2D>> pages;
+		pages.reserve(m_Pages.size());
+
+		for (const Page& page : m_Pages)
+		{
+			Ref<Texture2D> texture = Texture2D::Create(page.Width, page.Height);
+			texture->SetData(const_cast<uint8_t*>(page.Pixels.data()), static_cast<uint32_t>(page.Pixels.size()));
+			pages.push_back(std::move(texture));
+		}
+
+		return CreateRef<TextureAtlas>(std::move(pages), GetRegions());
+	}
+
+	bool TextureAtlasBuilder::Save(const std::string& atlasPath) const
+	{
+		SS_PROFILE_FUNCTION();
+
+		const std::filesystem::path path(atlasPath);
+
+		std::ofstream out(atlasPath);
+		if (!out)
+		{
+			SS_CORE_ERROR("Could not open file '{0}'", atlasPath);
+			return false;
+		}
+
+		// Pages are stored bottom row first, PNGs top row first
+		stbi_flip_vertically_on_write(1);
+
+		bool success = true;
+		for (uint32_t i = 0; i < m_Pages.size() && success; i++)
+		{
+			const Page& page = m_Pages[i];
+			const std::string fileName = GetPageFileName(path, i);
+
+			success = stbi_write_png((path.parent_path() / fileName).string().c_str(), static_cast<int>(page.Width),
+			                         static_cast<int>(page.Height), BytesPerPixel, page.Pixels.data(),
+			                         static_cast<int>(page.Width * BytesPerPixel)) != 0;
+
+			out << "page " << fileName << '\n';
+		}
+
+		stbi_flip_vertically_on_write(0);
+
+		if (!success)
+		{
+			SS_CORE_ERROR("Could not write the pages of texture atlas '{0}'", atlasPath);
+			return false;
+		}
+
+		// Pixel rectangles without padding, origin at the bottom left of the page
+		for (size_t i = 0; i < m_Images.size(); i++)
+		{
+			const Image& image = m_Images[i];
+			const Placement& placement = m_Placements[i];
+
+			out << "region " << placement.Page << ' ' << placement.X << ' ' << placement.Y << ' '
+				<< image.Width << ' ' << image.Height << ' ' << image.Name << '\n';
+		}
+
+		return true;
+	}
+
+	std::unordered_map<std::string, TextureAtlas::Region> TextureAtlasBuilder::GetRegions() const
+	{
+		SS_CORE_ASSERT(m_Placements.size() == m_Images.size(), "TextureAtlasBuilder has to be packed first!");
+
+		std::unordered_map<std::string, TextureAtlas::Region> regions;
+		regions.reserve(m_Images.size());
+
+		for (size_t i = 0; i < m_Images.size(); i++)
+		{
+			const Image& image = m_Images[i];
+			const Placement& placement = m_Placements[i];
+			const Page& page = m_Pages[placement.Page];
+
+			regions[image.Name] = {
+				placement.Page, GetUVRect(placement.X, placement.Y, image.Width, image.Height, page.Width, page.Height)
+			};
+		}
+
+		return regions;
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "SubTexture2D.hpp"
+#include "Texture.hpp"
+
+namespace Snowstorm
+{
+	// A set of texture pages with named regions packed into them
+	// Sprites drawn from the same page share a texture slot, so a scene made of many small images needs only a few
+	// batches. Atlases are created by a TextureAtlasBuilder at runtime or loaded from files it saved.
+	class TextureAtlas
+	{
+	public:
+		struct Region
+		{
+			uint32_t Page = 0;
+			glm::vec4 UVRect{0.0f, 0.0f, 1.0f, 1.0f}; // Min (xy) and max (zw) texture coordinates within the page
+		};
+
+		TextureAtlas(std::vector<Ref<Texture2D>> pages, std::unordered_map<std::string, Region> regions);
+
+		[[nodiscard]] uint32_t GetPageCount() const { return static_cast<uint32_t>(m_Pages.size()); }
+		[[nodiscard]] const Ref<Texture2D>& GetPage(const uint32_t index) const { return m_Pages[index]; }
+
+		// Returns nullptr if no image with that name was packed
+		[[nodiscard]] const Region* Find(const std::string& name) const;
+		[[nodiscard]] Ref<SubTexture2D> GetSubTexture(const std::string& name) const;
+
+		// Points a sprite at the atlas region of the image its texture was loaded from, mapping uvRect into the region.
+		// Returns false and leaves both untouched if the texture isn't part of the atlas.
+		bool Remap(Ref<Texture2D>& texture, glm::vec4& uvRect) const;
+
+		// Loads an atlas written by TextureAtlasBuilder::Save
+		static Ref<TextureAtlas> Load(const std::string& atlasPath);
+
+	private:
+		std::vector<Ref<Texture2D>> m_Pages;
+		std::unordered_map<std::string, Region> m_Regions;
+	};
+
+	// Packs RGBA8 images into atlas pages using MaxRects (best short side fit)
+	// Every image gets a border of padding pixels repeating its edge pixels, so bilinear filtering and lower mip levels
+	// never sample a neighbouring image.
+	class TextureAtlasBuilder
+	{
+	public:
+		// pixels are width * height RGBA8 texels, bottom row first like texture uploads
+		void AddImage(const std::string& name, const uint8_t* pixels, uint32_t width, uint32_t height);
+		// The file path becomes the image name, which lets Remap find it through Texture::GetPath
+		bool AddImage(const std::string& path);
+
+		// Packs all added images, opening new pages once a page of maxPageSize x maxPageSize is full.
+		// Fails if an image doesn't fit on an empty page.
+		bool Pack(uint32_t maxPageSize = 2048, uint32_t padding = 2);
+
+		// Uploads the packed pages (render thread only)
+		[[nodiscard]] Ref<TextureAtlas> CreateAtlas() const;
+
+		// Writes the packed pages as PNG files next to atlasPath and the region list to atlasPath, for offline builds
+		bool Save(const std::string& atlasPath) const;
+
+		[[nodiscard]] uint32_t GetPageCount() const { return static_cast<uint32_t>(m_Pages.size()); }
+
+	private:
+		struct Image
+		{
+			std::string Name;
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			std::vector<uint8_t> Pixels;
+		};
+
+		// Pixel rectangle of an image on its page, excluding the padding
+		struct Placement
+		{
+			uint32_t Page = 0;
+			uint32_t X = 0;
+			uint32_t Y = 0;
+		};
+
+		struct Page
+		{
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+			std::vector<uint8_t> Pixels;
+		};
+
+		[[nodiscard]] std::unordered_map<std::string, TextureAtlas::Region> GetRegions() const;
+
+		std::vector<Image> m_Images;
+		std::vector<Placement> m_Placements; // Parallel to m_Images
+		std::vector<Page> m_Pages;
+	};
+}
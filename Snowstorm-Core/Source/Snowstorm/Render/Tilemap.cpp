@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "Tilemap.hpp"
+
+namespace Snowstorm
+{
+	namespace
+	{
+		constexpr glm::vec2 TileCorners[4] = {
+			{0.0f, 0.0f},
+			{1.0f, 0.0f},
+			{1.0f, 1.0f},
+			{0.0f, 1.0f}
+		};
+	}
+
+	Tilemap::Tilemap(const uint32_t width, const uint32_t height, Ref<Texture2D> tileset, const glm::uvec2& tileSize)
+		: m_Width(width), m_Height(height), m_Tiles(static_cast<size_t>(width) * height, 0), m_Tileset(std::move(tileset)),
+		  m_ChunkCountX((width + ChunkSize - 1) / ChunkSize), m_ChunkCountY((height + ChunkSize - 1) / ChunkSize)
+	{
+		SS_PROFILE_FUNCTION();
+
+		SS_CORE_ASSERT(m_Tileset, "Tilemap needs a tileset!");
+		SS_CORE_ASSERT(tileSize.x > 0 && tileSize.y > 0, "Tile size can't be zero!");
+
+		m_Chunks.resize(static_cast<size_t>(m_ChunkCountX) * m_ChunkCountY);
+
+		// Textures are stored bottom row first, tiles are counted from the top
+		const uint32_t columns = m_Tileset->GetWidth() / tileSize.x;
+		const uint32_t rows = m_Tileset->GetHeight() / tileSize.y;
+		const glm::vec2 cellSize = {
+			static_cast<float>(tileSize.x) / static_cast<float>(m_Tileset->GetWidth()),
+			static_cast<float>(tileSize.y) / static_cast<float>(m_Tileset->GetHeight())
+		};
+
+		m_TileUVRects.resize(static_cast<size_t>(columns) * rows + 1);
+		for (uint32_t row = 0; row < rows; row++)
+		{
+			for (uint32_t column = 0; column < columns; column++)
+			{
+				const glm::vec2 min = {column * cellSize.x, 1.0f - (row + 1) * cellSize.y};
+				m_TileUVRects[row * columns + column + 1] = {min, min + cellSize};
+			}
+		}
+	}
+
+	void Tilemap::SetTile(const uint32_t x, const uint32_t y, const uint16_t tile)
+	{
+		SS_CORE_ASSERT(x < m_Width && y < m_Height, "Tile is outside of the tilemap!");
+		SS_CORE_ASSERT(tile < m_TileUVRects.size(), "Tile is outside of the tileset!");
+
+		uint16_t& current = m_Tiles[y * m_Width + x];
+		if (current == tile)
+		{
+			return;
+		}
+
+		current = tile;
+		GetChunk(x / ChunkSize, y / ChunkSize).Dirty = true;
+	}
+
+	uint32_t Tilemap::BuildChunkVertices(const uint32_t chunkX, const uint32_t chunkY,
+	                                     std::vector<TilemapVertex>& vertices) const
+	{
+		const uint32_t beginX = chunkX * ChunkSize;
+		const uint32_t beginY = chunkY * ChunkSize;
+		const uint32_t endX = std::min(beginX + ChunkSize, m_Width);
+		const uint32_t endY = std::min(beginY + ChunkSize, m_Height);
+
+		vertices.clear();
+
+		for (uint32_t y = beginY; y < endY; y++)
+		{
+			for (uint32_t x = beginX; x < endX; x++)
+			{
+				const uint16_t tile = m_Tiles[y * m_Width + x];
+				if (tile == 0)
+				{
+					continue;
+				}
+
+				const glm::vec4& uvRect = m_TileUVRects[tile];
+				const glm::vec2 origin = {static_cast<float>(x), static_cast<float>(y)};
+
+				for (const glm::vec2& corner : TileCorners)
+				{
+					vertices.push_back({
+						origin + corner,
+						mix(glm::vec2{uvRect.x, uvRect.y}, glm::vec2{uvRect.z, uvRect.w}, corner)
+					});
+				}
+			}
+		}
+
+		return static_cast<uint32_t>(vertices.size() / 4);
+	}
+}
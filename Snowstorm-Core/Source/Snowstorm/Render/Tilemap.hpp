@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Buffer.hpp"
+#include "Texture.hpp"
+#include "VertexArray.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	struct TilemapVertex
+	{
+		glm::vec2 Position; // In tiles, relative to the tilemap origin
+		glm::vec2 TexCoord;
+	};
+
+	// Cached GPU geometry of ChunkSize x ChunkSize tiles, owned by TilemapRenderer
+	struct TilemapChunk
+	{
+		Ref<VertexBuffer> Vertices;
+		Ref<VertexArray> Geometry;
+		uint32_t QuadCapacity = 0; // Quads Vertices has room for
+
+		uint32_t QuadCount = 0; // Non-empty tiles
+		bool Dirty = true; // Tiles changed since the geometry was built
+		uint64_t LastDrawnScene = 0;
+	};
+
+	// Grid of tiles drawn from a single tileset texture
+	// Tiles are grouped into chunks whose vertices are built once and only rebuilt after one of their tiles changes,
+	// which keeps the per-frame cost proportional to the visible area instead of the map size.
+	class Tilemap final : public NonCopyable
+	{
+	public:
+		// Tiles per chunk side
+		static constexpr uint32_t ChunkSize = 64;
+
+		// tileSize is the size of a single tile in the tileset, in pixels
+		Tilemap(uint32_t width, uint32_t height, Ref<Texture2D> tileset, const glm::uvec2& tileSize);
+
+		// 0 leaves the tile empty, n uses the n-th tile of the tileset counted row by row from its top left corner
+		void SetTile(uint32_t x, uint32_t y, uint16_t tile);
+		[[nodiscard]] uint16_t GetTile(uint32_t x, uint32_t y) const { return m_Tiles[y * m_Width + x]; }
+
+		[[nodiscard]] uint32_t GetWidth() const { return m_Width; }
+		[[nodiscard]] uint32_t GetHeight() const { return m_Height; }
+		[[nodiscard]] const Ref<Texture2D>& GetTileset() const { return m_Tileset; }
+
+		[[nodiscard]] uint32_t GetChunkCountX() const { return m_ChunkCountX; }
+		[[nodiscard]] uint32_t GetChunkCountY() const { return m_ChunkCountY; }
+		[[nodiscard]] TilemapChunk& GetChunk(const uint32_t chunkX, const uint32_t chunkY)
+		{
+			return m_Chunks[chunkY * m_ChunkCountX + chunkX];
+		}
+
+		// Writes one quad (four vertices) per non-empty tile of the chunk, returns the quad count
+		uint32_t BuildChunkVertices(uint32_t chunkX, uint32_t chunkY, std::vector<TilemapVertex>& vertices) const;
+
+	private:
+		uint32_t m_Width;
+		uint32_t m_Height;
+		std::vector<uint16_t> m_Tiles;
+
+		Ref<Texture2D> m_Tileset;
+		std::vector<glm::vec4> m_TileUVRects; // Indexed by tile, min (xy) and max (zw) texture coordinates
+
+		uint32_t m_ChunkCountX;
+		uint32_t m_ChunkCountY;
+		std::vector<TilemapChunk> m_Chunks;
+		std::vector<uint32_t> m_ResidentChunks; // Indices of the chunks that currently hold GPU geometry
+
+		friend class TilemapRenderer;
+	};
+}
@@ -0,0 +1,268 @@
+#include "pch.h"
+#include "TilemapRenderer.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "RenderCommand.hpp"
+#include "Shader.hpp"
+
+#include "Snowstorm/Core/JobSystem.hpp"
+
+namespace Snowstorm
+{
+	namespace
+	{
+		constexpr uint32_t MaxChunkQuads = Tilemap::ChunkSize * Tilemap::ChunkSize;
+		constexpr uint32_t MaxChunkIndices = MaxChunkQuads * 6;
+
+		// Chunks per tilemap that keep their geometry on the GPU, the least recently drawn ones are released beyond this
+		constexpr uint32_t MaxResidentChunks = 256;
+
+		constexpr glm::vec2 ViewCorners[4] = {
+			{-1.0f, -1.0f},
+			{1.0f, -1.0f},
+			{1.0f, 1.0f},
+			{-1.0f, 1.0f}
+		};
+
+		struct TilemapRendererStorage
+		{
+			Ref<Shader> TilemapShader;
+			Ref<IndexBuffer> ChunkIndexBuffer;
+
+			UniformHandle TransformUniform;
+			UniformHandle ColorUniform;
+			UniformHandle TilesetUniform;
+		};
+
+		TilemapRendererStorage s_Data;
+
+		void ReleaseChunk(TilemapChunk& chunk)
+		{
+			chunk.Vertices = nullptr;
+			chunk.Geometry = nullptr;
+			chunk.QuadCapacity = 0;
+			chunk.Dirty = true;
+		}
+	}
+
+	void TilemapRenderer::Init()
+	{
+		SS_PROFILE_FUNCTION();
+
+		std::vector<uint32_t> indices(MaxChunkIndices);
+
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < MaxChunkIndices; i += 6)
+		{
+			indices[i + 0] = offset + 0;
+			indices[i + 1] = offset + 1;
+			indices[i + 2] = offset + 2;
+
+			indices[i + 3] = offset + 2;
+			indices[i + 4] = offset + 3;
+			indices[i + 5] = offset + 0;
+
+			offset += 4;
+		}
+
+		s_Data.ChunkIndexBuffer = IndexBuffer::Create(indices.data(), MaxChunkIndices);
+		s_Data.TilemapShader = Shader::Create("assets/shaders/Tilemap.glsl");
+
+		s_Data.TransformUniform = s_Data.TilemapShader->GetUniformHandle("u_Transform");
+		s_Data.ColorUniform = s_Data.TilemapShader->GetUniformHandle("u_Color");
+		s_Data.TilesetUniform = s_Data.TilemapShader->GetUniformHandle("u_Tileset");
+	}
+
+	void TilemapRenderer::Shutdown()
+	{
+		SS_PROFILE_FUNCTION();
+
+		s_Data = {};
+	}
+
+	void TilemapRenderer::BeginScene(const ViewData& view)
+	{
+		m_ViewProjection = view.ViewProjection;
+		m_SceneIndex++;
+	}
+
+	void TilemapRenderer::DrawTilemap(Tilemap& tilemap, const glm::mat4& transform, const glm::vec4& tintColor)
+	{
+		SS_PROFILE_FUNCTION();
+
+		const uint32_t chunkCountX = tilemap.GetChunkCountX();
+		const uint32_t chunkCountY = tilemap.GetChunkCountY();
+		const uint32_t totalChunks = chunkCountX * chunkCountY;
+
+		// Project the corners of the view onto the tilemap plane (z = 0 in tilemap space) to get the visible tile range
+		const glm::mat4 inverseModelViewProjection = inverse(m_ViewProjection * transform);
+
+		glm::vec2 visibleMin{FLT_MAX};
+		glm::vec2 visibleMax{-FLT_MAX};
+		for (const glm::vec2& corner : ViewCorners)
+		{
+			glm::vec4 nearPoint = inverseModelViewProjection * glm::vec4{corner, -1.0f, 1.0f};
+			glm::vec4 farPoint = inverseModelViewProjection * glm::vec4{corner, 1.0f, 1.0f};
+			nearPoint /= nearPoint.w;
+			farPoint /= farPoint.w;
+
+			// Rays that miss the plane are clamped to the near or far plane, which only makes the range conservative
+			const float deltaZ = nearPoint.z - farPoint.z;
+			const float t = std::abs(deltaZ) > 1e-6f ? std::clamp(nearPoint.z / deltaZ, 0.0f, 1.0f) : 0.0f;
+			const glm::vec2 point = mix(glm::vec2{nearPoint}, glm::vec2{farPoint}, t);
+
+			visibleMin = min(visibleMin, point);
+			visibleMax = max(visibleMax, point);
+		}
+
+		m_VisibleChunks.clear();
+		m_DirtyChunks.clear();
+
+		if (visibleMax.x >= 0.0f && visibleMax.y >= 0.0f &&
+			visibleMin.x <= static_cast<float>(tilemap.GetWidth()) && visibleMin.y <= static_cast<float>(tilemap.GetHeight()))
+		{
+			const auto toChunk = [](const float tile, const uint32_t chunkCount)
+			{
+				const float chunk = std::floor(tile / static_cast<float>(Tilemap::ChunkSize));
+				return static_cast<uint32_t>(std::clamp(chunk, 0.0f, static_cast<float>(chunkCount - 1)));
+			};
+
+			const uint32_t beginX = toChunk(visibleMin.x, chunkCountX);
+			const uint32_t beginY = toChunk(visibleMin.y, chunkCountY);
+			const uint32_t endX = toChunk(visibleMax.x, chunkCountX);
+			const uint32_t endY = toChunk(visibleMax.y, chunkCountY);
+
+			for (uint32_t chunkY = beginY; chunkY <= endY; chunkY++)
+			{
+				for (uint32_t chunkX = beginX; chunkX <= endX; chunkX++)
+				{
+					const uint32_t index = chunkY * chunkCountX + chunkX;
+					m_VisibleChunks.push_back(index);
+
+					if (tilemap.m_Chunks[index].Dirty)
+					{
+						m_DirtyChunks.push_back(index);
+					}
+				}
+			}
+		}
+
+		m_Stats.VisibleChunks += static_cast<uint32_t>(m_VisibleChunks.size());
+		m_Stats.CulledChunks += totalChunks - static_cast<uint32_t>(m_VisibleChunks.size());
+
+		// Rebuild the visible chunks whose tiles changed, vertices on the job system, uploads here
+		if (!m_DirtyChunks.empty())
+		{
+			const auto dirtyCount = static_cast<uint32_t>(m_DirtyChunks.size());
+			if (m_ChunkVertices.size() < dirtyCount)
+			{
+				m_ChunkVertices.resize(dirtyCount);
+			}
+
+			JobSystem::ParallelFor(dirtyCount, 1, [&](const uint32_t begin, const uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					const uint32_t index = m_DirtyChunks[i];
+					tilemap.m_Chunks[index].QuadCount = tilemap.BuildChunkVertices(index % chunkCountX, index / chunkCountX,
+					                                                               m_ChunkVertices[i]);
+				}
+			});
+
+			for (uint32_t i = 0; i < dirtyCount; i++)
+			{
+				const uint32_t index = m_DirtyChunks[i];
+				TilemapChunk& chunk = tilemap.m_Chunks[index];
+				const std::vector<TilemapVertex>& vertices = m_ChunkVertices[i];
+				const auto size = static_cast<uint32_t>(vertices.size() * sizeof(TilemapVertex));
+
+				chunk.Dirty = false;
+				if (chunk.QuadCount == 0)
+				{
+					continue;
+				}
+
+				if (chunk.QuadCount > chunk.QuadCapacity)
+				{
+					if (!chunk.Vertices)
+					{
+						tilemap.m_ResidentChunks.push_back(index);
+					}
+
+					chunk.Vertices = VertexBuffer::Create(vertices.data(), size);
+					chunk.Vertices->SetLayout({
+						{ShaderDataType::Float2, "a_Position"},
+						{ShaderDataType::Float2, "a_TexCoord"},
+					});
+
+					chunk.Geometry = VertexArray::Create();
+					chunk.Geometry->AddVertexBuffer(chunk.Vertices);
+					chunk.Geometry->SetIndexBuffer(s_Data.ChunkIndexBuffer);
+
+					chunk.QuadCapacity = chunk.QuadCount;
+				}
+				else
+				{
+					chunk.Vertices->SetSubData(vertices.data(), size, 0);
+				}
+
+				m_Stats.RebuiltChunks++;
+				m_Stats.UploadBytes += size;
+			}
+		}
+
+		// Draw
+		s_Data.TilemapShader->Bind();
+		s_Data.TilemapShader->SetUniform(s_Data.TransformUniform, transform);
+		s_Data.TilemapShader->SetUniform(s_Data.ColorUniform, tintColor);
+		s_Data.TilemapShader->SetUniform(s_Data.TilesetUniform, 0);
+
+		tilemap.GetTileset()->Bind(0);
+
+		for (const uint32_t index : m_VisibleChunks)
+		{
+			TilemapChunk& chunk = tilemap.m_Chunks[index];
+			if (chunk.QuadCount == 0)
+			{
+				continue;
+			}
+
+			chunk.Geometry->Bind();
+			RenderCommand::DrawIndexed(chunk.Geometry, chunk.QuadCount * 6);
+			chunk.LastDrawnScene = m_SceneIndex;
+
+			m_Stats.DrawCalls++;
+		}
+
+		// Give back the geometry of the chunks that have been out of view the longest
+		if (auto& resident = tilemap.m_ResidentChunks; resident.size() > MaxResidentChunks)
+		{
+			const auto byLastDrawn = [&](const uint32_t a, const uint32_t b)
+			{
+				return tilemap.m_Chunks[a].LastDrawnScene > tilemap.m_Chunks[b].LastDrawnScene;
+			};
+			std::nth_element(resident.begin(), resident.begin() + MaxResidentChunks, resident.end(), byLastDrawn);
+
+			// Chunks drawn in this scene are kept even when they exceed the budget
+			const auto evicted = std::remove_if(resident.begin() + MaxResidentChunks, resident.end(), [&](const uint32_t index)
+			{
+				TilemapChunk& chunk = tilemap.m_Chunks[index];
+				if (chunk.LastDrawnScene == m_SceneIndex)
+				{
+					return false;
+				}
+
+				ReleaseChunk(chunk);
+				return true;
+			});
+			resident.erase(evicted, resident.end());
+		}
+	}
+
+	void TilemapRenderer::ResetStats()
+	{
+		m_Stats = {};
+	}
+}
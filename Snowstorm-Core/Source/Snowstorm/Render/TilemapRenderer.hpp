@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Tilemap.hpp"
+#include "ViewSingleton.hpp"
+
+#include "Snowstorm/Utility/NonCopyable.hpp"
+
+namespace Snowstorm
+{
+	// Draws tilemaps chunk by chunk from their cached geometry
+	// Only chunks overlapping the camera's view are considered. Dirty visible chunks are rebuilt on the job system
+	// before drawing, and chunks that haven't been drawn for a while give their GPU memory back. Render thread only.
+	class TilemapRenderer final : public NonCopyable
+	{
+	public:
+		// Resources shared by all instances (shader, chunk indices)
+		static void Init();
+		static void Shutdown();
+
+		// The view has to be bound at ViewSingleton::Binding while drawing, it is only read here to cull chunks
+		void BeginScene(const ViewData& view);
+
+		// Tiles are one unit in size before transform is applied, with tile (0, 0) covering [0, 1] x [0, 1]
+		void DrawTilemap(Tilemap& tilemap, const glm::mat4& transform, const glm::vec4& tintColor = glm::vec4{1.0f});
+
+		struct Statistics
+		{
+			uint32_t DrawCalls = 0;
+			uint32_t VisibleChunks = 0;
+			uint32_t CulledChunks = 0;
+			uint32_t RebuiltChunks = 0;
+			uint64_t UploadBytes = 0;
+		};
+
+		void ResetStats();
+		[[nodiscard]] Statistics GetStats() const { return m_Stats; }
+
+	private:
+		glm::mat4 m_ViewProjection{1.0f};
+		uint64_t m_SceneIndex = 0;
+
+		// Per-frame scratch, kept to avoid reallocating
+		std::vector<uint32_t> m_VisibleChunks;
+		std::vector<uint32_t> m_DirtyChunks;
+		std::vector<std::vector<TilemapVertex>> m_ChunkVertices;
+
+		Statistics m_Stats;
+	};
+}
@@ -10,6 +10,10 @@ namespace Snowstorm
 		virtual ~UniformBuffer() = default;
 
 		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+		// Points binding at part of the buffer, offset has to be a multiple of the UniformBufferAlignment capability
+		virtual void BindRange(uint32_t binding, uint32_t offset, uint32_t size) const = 0;
+
 		[[nodiscard]] virtual uint32_t GetRendererID() const = 0;
 
 		static std::shared_ptr<UniformBuffer> Create(uint32_t size, uint32_t binding);
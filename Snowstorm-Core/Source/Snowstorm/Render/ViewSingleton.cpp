@@ -0,0 +1,68 @@
+#include "pch.h"
+#include "ViewSingleton.hpp"
+
+#include <bit>
+#include <cstring>
+
+#include "RenderCommand.hpp"
+
+namespace Snowstorm
+{
+	void ViewSingleton::BeginFrame(const Timestep ts)
+	{
+		m_Views.clear();
+
+		m_DeltaTime = ts;
+		m_Time += ts;
+	}
+
+	uint32_t ViewSingleton::AddView(const Camera& camera, const glm::mat4& transform, const glm::uvec2& viewportSize)
+	{
+		ViewData& view = m_Views.emplace_back();
+		view.InverseView = transform;
+		view.View = inverse(transform);
+		view.Projection = camera.GetProjection();
+		view.InverseProjection = inverse(view.Projection);
+		view.ViewProjection = view.Projection * view.View;
+		view.InverseViewProjection = view.InverseView * view.InverseProjection;
+		view.CameraPosition = transform[3];
+		view.ViewportSize = viewportSize;
+		view.Time = m_Time;
+		view.DeltaTime = m_DeltaTime;
+
+		return static_cast<uint32_t>(m_Views.size() - 1);
+	}
+
+	void ViewSingleton::Upload()
+	{
+		SS_PROFILE_FUNCTION();
+
+		const auto viewCount = static_cast<uint32_t>(m_Views.size());
+		if (viewCount == 0)
+		{
+			return;
+		}
+
+		if (!m_Buffer || m_Capacity < viewCount)
+		{
+			const uint32_t alignment = RenderCommand::GetCapabilities().UniformBufferAlignment;
+			m_Stride = (static_cast<uint32_t>(sizeof(ViewData)) + alignment - 1) / alignment * alignment;
+			m_Capacity = std::bit_ceil(viewCount);
+			m_Buffer = UniformBuffer::Create(m_Capacity * m_Stride, Binding);
+		}
+
+		m_Staging.resize(static_cast<size_t>(viewCount) * m_Stride);
+		for (uint32_t i = 0; i < viewCount; i++)
+		{
+			std::memcpy(m_Staging.data() + static_cast<size_t>(i) * m_Stride, &m_Views[i], sizeof(ViewData));
+		}
+
+		m_Buffer->SetData(m_Staging.data(), static_cast<uint32_t>(m_Staging.size()));
+	}
+
+	void ViewSingleton::Bind(const uint32_t index) const
+	{
+		SS_CORE_ASSERT(m_Buffer && index < m_Views.size(), "View has to be added and uploaded before binding!");
+		m_Buffer->BindRange(Binding, index * m_Stride, sizeof(ViewData));
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Camera.hpp"
+#include "UniformBuffer.hpp"
+
+#include "Snowstorm/Core/Timestep.h"
+#include "Snowstorm/ECS/Singleton.hpp"
+
+namespace Snowstorm
+{
+	// What one camera sees this frame, in the std140 layout of the ViewData block every shader declares at binding 0
+	struct ViewData
+	{
+		glm::mat4 View{1.0f};
+		glm::mat4 Projection{1.0f};
+		glm::mat4 ViewProjection{1.0f};
+		glm::mat4 InverseView{1.0f}; // The camera's transform
+		glm::mat4 InverseProjection{1.0f};
+		glm::mat4 InverseViewProjection{1.0f};
+		glm::vec4 CameraPosition{0.0f, 0.0f, 0.0f, 1.0f};
+		glm::vec2 ViewportSize{0.0f}; // In pixels
+		float Time = 0.0f; // Seconds since the first frame
+		float DeltaTime = 0.0f;
+
+		[[nodiscard]] Frustum GetFrustum() const { return Frustum(ViewProjection); }
+	};
+
+	static_assert(sizeof(ViewData) == 6 * sizeof(glm::mat4) + 2 * sizeof(glm::vec4), "ViewData has to match std140");
+
+	// The views of the current frame, computed once per camera and uploaded together into one uniform buffer
+	// Renderers read the matrices they need on the CPU from GetView and shaders from the block, which Bind points at
+	// a view's range without uploading anything.
+	class ViewSingleton final : public Singleton
+	{
+	public:
+		static constexpr uint32_t Binding = 0;
+
+		// Drops the views of the previous frame
+		void BeginFrame(Timestep ts);
+
+		// Computes the view of a camera placed at transform, returns its index for GetView and Bind
+		uint32_t AddView(const Camera& camera, const glm::mat4& transform, const glm::uvec2& viewportSize);
+
+		[[nodiscard]] const ViewData& GetView(const uint32_t index) const { return m_Views[index]; }
+
+		// Uploads every view added since BeginFrame (render thread only)
+		void Upload();
+
+		void Bind(uint32_t index) const;
+
+	private:
+		std::vector<ViewData> m_Views;
+
+		Ref<UniformBuffer> m_Buffer;
+		uint32_t m_Capacity = 0; // In views
+		uint32_t m_Stride = 0; // Bytes between views, a multiple of the uniform buffer alignment
+
+		std::vector<uint8_t> m_Staging;
+
+		float m_Time = 0.0f;
+		float m_DeltaTime = 0.0f;
+	};
+}
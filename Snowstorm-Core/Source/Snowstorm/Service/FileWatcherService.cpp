@@ -0,0 +1,323 @@
+#include "pch.h"
+#include "FileWatcherService.hpp"
+
+#include "Snowstorm/Core/Application.h"
+#include "Snowstorm/Events/ApplicationEvent.h"
+
+#if defined(SS_PLATFORM_LINUX)
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Snowstorm
+{
+#if defined(SS_PLATFORM_WINDOWS)
+	struct FileWatcherService::Backend
+	{
+		HANDLE Directory = INVALID_HANDLE_VALUE;
+		HANDLE Changed = CreateEventW(nullptr, TRUE, FALSE, nullptr); // Signalled when a read completes
+		HANDLE Wake = CreateEventW(nullptr, TRUE, FALSE, nullptr); // Set by the destructor to end the thread's wait
+		OVERLAPPED Overlapped{};
+		alignas(DWORD) std::array<std::byte, 64 * 1024> Buffer; // Reads over the network fail above 64 KiB
+
+		~Backend()
+		{
+			if (Directory != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(Directory);
+			}
+			if (Changed)
+			{
+				CloseHandle(Changed);
+			}
+			if (Wake)
+			{
+				CloseHandle(Wake);
+			}
+		}
+
+		bool Open(const std::filesystem::path& root)
+		{
+			Directory = CreateFileW(root.c_str(), FILE_LIST_DIRECTORY,
+			                        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+			                        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+			return Directory != INVALID_HANDLE_VALUE && Changed && Wake;
+		}
+
+		// Starts waiting for changes anywhere below the directory, completion signals Changed
+		bool Read()
+		{
+			ResetEvent(Changed);
+			Overlapped = {};
+			Overlapped.hEvent = Changed;
+
+			constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+			return ReadDirectoryChangesW(Directory, Buffer.data(), static_cast<DWORD>(Buffer.size()), TRUE, filter,
+			                             nullptr, &Overlapped, nullptr);
+		}
+
+		// The buffer is written by the kernel until the read completes, so it must not be left pending
+		void Cancel()
+		{
+			DWORD length = 0;
+			CancelIoEx(Directory, &Overlapped);
+			GetOverlappedResult(Directory, &Overlapped, &length, TRUE);
+		}
+	};
+#elif defined(SS_PLATFORM_LINUX)
+	struct FileWatcherService::Backend
+	{
+		int Inotify = inotify_init1(IN_CLOEXEC);
+		int Wake = eventfd(0, EFD_CLOEXEC); // Written to by the destructor to end the thread's wait
+		std::unordered_map<int, std::filesystem::path> Directories; // By watch descriptor
+
+		~Backend()
+		{
+			if (Inotify >= 0)
+			{
+				close(Inotify);
+			}
+			if (Wake >= 0)
+			{
+				close(Wake);
+			}
+		}
+
+		// Directories are watched instead of files, a file replaced on save would otherwise take its watch with it
+		void WatchTree(const std::filesystem::path& root)
+		{
+			Watch(root);
+
+			std::error_code error;
+			for (auto it = std::filesystem::recursive_directory_iterator(
+				     root, std::filesystem::directory_options::skip_permission_denied, error);
+			     !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+			{
+				if (std::error_code typeError; it->is_directory(typeError))
+				{
+					Watch(it->path());
+				}
+			}
+		}
+
+		void Watch(const std::filesystem::path& directory)
+		{
+			constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+			if (const int descriptor = inotify_add_watch(Inotify, directory.c_str(), mask); descriptor >= 0)
+			{
+				Directories[descriptor] = directory;
+			}
+		}
+	};
+#endif
+
+	FileWatcherService::FileWatcherService(std::filesystem::path root)
+		: m_Root(std::move(root)), m_Backend(CreateScope<Backend>())
+	{
+		SS_PROFILE_FUNCTION();
+
+		if (std::error_code error; !std::filesystem::is_directory(m_Root, error))
+		{
+			SS_CORE_WARN("Not watching '{0}' for changes, it isn't a directory", m_Root.string());
+			return;
+		}
+
+#if defined(SS_PLATFORM_WINDOWS)
+		if (!m_Backend->Open(m_Root))
+		{
+			SS_CORE_ERROR("Could not watch '{0}' for changes: error {1}", m_Root.string(), GetLastError());
+			return;
+		}
+#elif defined(SS_PLATFORM_LINUX)
+		if (m_Backend->Inotify < 0 || m_Backend->Wake < 0)
+		{
+			SS_CORE_ERROR("Could not watch '{0}' for changes: {1}", m_Root.string(), std::strerror(errno));
+			return;
+		}
+#endif
+
+		m_Thread = std::thread(&FileWatcherService::Run, this);
+	}
+
+	FileWatcherService::~FileWatcherService()
+	{
+		SS_PROFILE_FUNCTION();
+
+		m_Running = false;
+
+#if defined(SS_PLATFORM_WINDOWS)
+		if (m_Backend->Wake)
+		{
+			SetEvent(m_Backend->Wake);
+		}
+#elif defined(SS_PLATFORM_LINUX)
+		constexpr uint64_t wake = 1;
+		[[maybe_unused]] const ssize_t written = write(m_Backend->Wake, &wake, sizeof(wake));
+#endif
+
+		if (m_Thread.joinable())
+		{
+			m_Thread.join();
+		}
+	}
+
+	void FileWatcherService::OnUpdate(Timestep ts)
+	{
+		std::vector<std::string> settled;
+		{
+			const std::lock_guard lock(m_Mutex);
+			const Clock::time_point now = Clock::now();
+
+			std::erase_if(m_Changes, [&](const auto& change)
+			{
+				if (now - change.second < SettleTime)
+				{
+					return false;
+				}
+
+				settled.push_back(change.first);
+				return true;
+			});
+		}
+
+		for (std::string& path : settled)
+		{
+			FileChangedEvent event(std::move(path));
+			Application::Get().OnEvent(event);
+		}
+	}
+
+	void FileWatcherService::PostUpdate(Timestep ts)
+	{
+	}
+
+	void FileWatcherService::Run()
+	{
+		Backend& backend = *m_Backend;
+
+#if defined(SS_PLATFORM_WINDOWS)
+		while (m_Running)
+		{
+			if (!backend.Read())
+			{
+				SS_CORE_ERROR("Stopped watching '{0}' for changes: error {1}", m_Root.string(), GetLastError());
+				return;
+			}
+
+			const HANDLE handles[] = {backend.Changed, backend.Wake};
+			const DWORD count = static_cast<DWORD>(std::size(handles));
+			if (WaitForMultipleObjects(count, handles, FALSE, INFINITE) != WAIT_OBJECT_0)
+			{
+				backend.Cancel();
+				return;
+			}
+
+			DWORD length = 0;
+			if (!GetOverlappedResult(backend.Directory, &backend.Overlapped, &length, FALSE))
+			{
+				SS_CORE_ERROR("Stopped watching '{0}' for changes: error {1}", m_Root.string(), GetLastError());
+				return;
+			}
+
+			if (length == 0)
+			{
+				SS_CORE_WARN("Too many changes below '{0}', some were missed", m_Root.string());
+				continue;
+			}
+
+			for (DWORD offset = 0;;)
+			{
+				const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(backend.Buffer.data() + offset);
+				if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED ||
+					info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+				{
+					const std::filesystem::path path = m_Root / std::wstring_view(
+						info->FileName, info->FileNameLength / sizeof(WCHAR));
+
+					// Directories report a modification whenever one of their files changes
+					if (std::error_code error; std::filesystem::is_regular_file(path, error))
+					{
+						Notify(path);
+					}
+				}
+
+				if (info->NextEntryOffset == 0)
+				{
+					break;
+				}
+				offset += info->NextEntryOffset;
+			}
+		}
+#elif defined(SS_PLATFORM_LINUX)
+		backend.WatchTree(m_Root);
+
+		alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+		while (m_Running)
+		{
+			pollfd descriptors[] = {{backend.Inotify, POLLIN, 0}, {backend.Wake, POLLIN, 0}};
+			if (poll(descriptors, std::size(descriptors), -1) < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				SS_CORE_ERROR("Stopped watching '{0}' for changes: {1}", m_Root.string(), std::strerror(errno));
+				return;
+			}
+
+			if (descriptors[1].revents & POLLIN)
+			{
+				return;
+			}
+
+			const ssize_t length = read(backend.Inotify, buffer.data(), buffer.size());
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					SS_CORE_WARN("Too many changes below '{0}', some were missed", m_Root.string());
+					continue;
+				}
+
+				if (event->mask & IN_IGNORED)
+				{
+					backend.Directories.erase(event->wd); // The directory was removed
+					continue;
+				}
+
+				const auto directory = backend.Directories.find(event->wd);
+				if (directory == backend.Directories.end() || event->len == 0)
+				{
+					continue;
+				}
+
+				const std::filesystem::path path = directory->second / event->name;
+				if (event->mask & IN_ISDIR)
+				{
+					// Files written before the watch existed are picked up with their next change
+					backend.WatchTree(path);
+				}
+				else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+				{
+					Notify(path);
+				}
+			}
+		}
+#endif
+	}
+
+	void FileWatcherService::Notify(const std::filesystem::path& path)
+	{
+		const std::lock_guard lock(m_Mutex);
+		m_Changes[path.lexically_normal().generic_string()] = Clock::now();
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "Service.hpp"
+
+#include "Snowstorm/Core/Base.h"
+
+namespace Snowstorm
+{
+	// Watches every file below a directory on a background thread and reports changes as FileChangedEvents
+	// Uses ReadDirectoryChangesW on Windows and inotify on Linux. The writes of one save, which editors often split
+	// into several steps, are delivered as a single event once the file has been quiet for SettleTime.
+	// Events are sent to the application from OnUpdate, so they arrive on the main thread.
+	class FileWatcherService final : public Service
+	{
+	public:
+		static constexpr std::chrono::milliseconds SettleTime{100};
+
+		explicit FileWatcherService(std::filesystem::path root);
+		~FileWatcherService() override;
+
+		void OnUpdate(Timestep ts) override;
+		void PostUpdate(Timestep ts) override;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Backend; // Platform specific watch state, only touched by the background thread and the destructor
+
+		void Run();
+		void Notify(const std::filesystem::path& path);
+
+		std::filesystem::path m_Root;
+		Scope<Backend> m_Backend;
+
+		std::mutex m_Mutex;
+		std::unordered_map<std::string, Clock::time_point> m_Changes; // Last change per path, guarded by m_Mutex
+
+		std::atomic<bool> m_Running{true};
+		std::thread m_Thread;
+	};
+}
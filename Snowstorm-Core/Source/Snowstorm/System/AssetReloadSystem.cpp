@@ -0,0 +1,68 @@
+#include "AssetReloadSystem.hpp"
+
+#include "Snowstorm/Events/ApplicationEvent.h"
+#include "Snowstorm/Render/MeshLibrarySingleton.hpp"
+#include "Snowstorm/Render/Shader.hpp"
+#include "Snowstorm/Render/Texture.hpp"
+#include "Snowstorm/World/Components.hpp"
+
+namespace Snowstorm
+{
+	void AssetReloadSystem::Execute(const Timestep ts)
+	{
+		const auto meshView = View<MeshComponent>();
+		const auto occluderView = View<OccluderComponent>();
+
+		auto& eventsHandler = SingletonView<EventsHandlerSingleton>();
+		auto& shaderLibrary = SingletonView<ShaderLibrarySingleton>();
+		auto& meshLibrary = SingletonView<MeshLibrarySingleton>();
+
+		for (const auto& change : eventsHandler.Process<FileChangedEvent>())
+		{
+			shaderLibrary.Reload(change->Path);
+
+			if (const uint32_t textureCount = Texture2D::ReloadFile(change->Path); textureCount > 0)
+			{
+				SS_CORE_INFO("Reloaded {0} textures from '{1}'", textureCount, change->Path);
+			}
+
+			// Meshes are replaced rather than updated, so the components using them are pointed at the new ones
+			for (const auto& [previous, current] : meshLibrary.Reload(change->Path))
+			{
+				for (const auto entity : meshView)
+				{
+					if (auto& [mesh, lod] = meshView.get<MeshComponent>(entity); mesh == previous)
+					{
+						mesh = current;
+						lod = 0;
+					}
+				}
+
+				for (const auto entity : occluderView)
+				{
+					if (auto& [occluderMesh] = occluderView.get<OccluderComponent>(entity); occluderMesh == previous)
+					{
+						occluderMesh = current;
+					}
+				}
+
+				SS_CORE_INFO("Reloaded mesh '{0}'", change->Path);
+			}
+		}
+
+		// Recompiles finish over the following frames, the shaders keep drawing with their previous program until then
+		for (auto& [filepath, result] : shaderLibrary.CollectReloads())
+		{
+			if (result.Succeeded)
+			{
+				SS_CORE_INFO("Reloaded shader '{0}'", filepath);
+				eventsHandler.PushEvent<ShaderReloadedEvent>(std::move(filepath));
+			}
+			else
+			{
+				SS_CORE_ERROR("Could not reload shader '{0}':\n{1}", filepath, result.Log);
+				eventsHandler.PushEvent<ShaderCompileFailedEvent>(std::move(filepath), std::move(result.Log));
+			}
+		}
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "Snowstorm/ECS/System.hpp"
+
+namespace Snowstorm
+{
+	// Reloads the shaders, meshes and textures whose files changed, see FileWatcherService
+	class AssetReloadSystem final : public System
+	{
+	public:
+		explicit AssetReloadSystem(const WorldRef world)
+			: System(world)
+		{
+		}
+
+		void Execute(Timestep ts) override;
+	};
+}
@@ -1,15 +1,34 @@
 #include "RenderSystem.hpp"
 
+#include <limits>
+
+#include "Snowstorm/Core/JobSystem.hpp"
 #include "Snowstorm/Events/ApplicationEvent.h"
+#include "Snowstorm/Render/Frustum.hpp"
 #include "Snowstorm/Render/RenderCommand.hpp"
-#include "Snowstorm/Render/Renderer2D.hpp"
+#include "Snowstorm/Render/RenderGraphSingleton.hpp"
+#include "Snowstorm/Render/Renderer2DSingleton.hpp"
 #include "Snowstorm/Render/Renderer3DSingleton.hpp"
+#include "Snowstorm/Render/ViewSingleton.hpp"
 #include "Snowstorm/World/Components.hpp"
 
 namespace Snowstorm
 {
 	namespace
 	{
+		struct RenderTarget
+		{
+			entt::entity Entity = entt::null;
+			Ref<Framebuffer> Framebuffer;
+
+			const Camera* MainCamera = nullptr;
+			glm::mat4 CameraTransform{1.0f};
+			uint32_t ViewIndex = 0; // Into the ViewSingleton, only set when there is a camera
+
+			Renderer2D* SpriteRenderer = nullptr;
+			RenderQueue2D* SpriteQueue = nullptr;
+		};
+
 		void PrepareFramebuffer(const Ref<Framebuffer>& framebuffer)
 		{
 			framebuffer->Bind();
@@ -34,6 +53,106 @@ namespace Snowstorm
 				}
 			}
 		}
+
+		// Sprites converted per job while filling a target's sprite queue
+		constexpr uint32_t SpritesPerJob = 2048;
+
+		// Meshes whose bounds and level of detail are updated, or whose draw packets are generated, per job
+		constexpr uint32_t MeshesPerJob = 1024;
+
+		// Simplification error a level of detail may show as a fraction of the viewport height, about a pixel at 1080p
+		constexpr float MaxLODScreenError = 1.0f / 1080.0f;
+		// How far past a switching point the screen size has to be before the level changes
+		constexpr float LODHysteresis = 0.15f;
+
+		// Only reads components and writes into the target's own queue and renderer, so targets can be recorded in parallel
+		void RecordSprites(const RenderTarget& target, const ViewData& view, const auto& spriteView,
+		                   const auto& textView)
+		{
+			std::vector<entt::entity> sprites;
+			for (const auto entity : spriteView)
+			{
+				if (const auto& [targetFramebuffer] = spriteView.template get<RenderTargetComponent>(entity);
+					targetFramebuffer == target.Entity) // Match framebuffer
+				{
+					sprites.push_back(entity);
+				}
+			}
+
+			std::vector<entt::entity> texts;
+			for (const auto entity : textView)
+			{
+				if (const auto& [targetFramebuffer] = textView.template get<RenderTargetComponent>(entity);
+					targetFramebuffer == target.Entity)
+				{
+					texts.push_back(entity);
+				}
+			}
+
+			// Layouts are only reshaped when their text changed, each one then adds its glyphs after the sprites
+			const auto textCount = static_cast<uint32_t>(texts.size());
+			JobSystem::ParallelFor(textCount, 1, [&](const uint32_t begin, const uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					auto& text = textView.template get<TextComponent>(texts[i]);
+					text.Layout.Update(text.Text, text.FontAsset);
+				}
+			});
+
+			const auto spriteCount = static_cast<uint32_t>(sprites.size());
+			std::vector<uint32_t> glyphOffsets(textCount);
+			uint32_t glyphCount = 0;
+			for (uint32_t i = 0; i < textCount; i++)
+			{
+				glyphOffsets[i] = spriteCount + glyphCount;
+				glyphCount += static_cast<uint32_t>(textView.template get<TextComponent>(texts[i]).Layout.GetQuads().size());
+			}
+
+			RenderQueue2D& queue = *target.SpriteQueue;
+			queue.Resize(spriteCount + glyphCount);
+
+			JobSystem::ParallelFor(spriteCount, SpritesPerJob, [&](const uint32_t begin, const uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					const auto& [transform, sprite] = spriteView.template get<TransformComponent, SpriteComponent>(sprites[i]);
+
+					queue.SetSprite(i, transform, sprite.TintColor, sprite.TextureInstance, sprite.UVRect,
+					                sprite.TextureInstance ? sprite.TilingFactor : 1.0f, sprite.Layer);
+				}
+			});
+
+			JobSystem::ParallelFor(textCount, 1, [&](const uint32_t begin, const uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; i++)
+				{
+					const auto& [transform, text] = textView.template get<TransformComponent, TextComponent>(texts[i]);
+					const TextLayout& layout = text.Layout;
+					if (layout.GetQuads().empty())
+					{
+						continue;
+					}
+
+					const glm::mat4 textTransform = transform;
+					const TextureAtlas& atlas = *layout.GetFont()->GetAtlas();
+
+					uint32_t index = glyphOffsets[i];
+					for (const TextLayout::GlyphQuad& quad : layout.GetQuads())
+					{
+						queue.SetSprite(index++, TextLayout::GetGlyphTransform(textTransform, quad), text.Color,
+						                atlas.GetPage(quad.Page), quad.UVRect, 1.0f, text.Layer);
+					}
+				}
+			});
+
+			queue.Cull(view.GetFrustum());
+			queue.Sort(view.View);
+
+			Renderer2D& renderer = *target.SpriteRenderer;
+			queue.Submit(renderer);
+			renderer.EndScene();
+		}
 	}
 
 	void RenderSystem::Execute(const Timestep ts)
@@ -41,11 +160,36 @@ namespace Snowstorm
 		const auto framebufferView = View<FramebufferComponent>();
 		const auto cameraView = View<TransformComponent, CameraComponent, RenderTargetComponent>();
 		const auto spriteView = View<TransformComponent, SpriteComponent, RenderTargetComponent>();
+		const auto textView = View<TransformComponent, TextComponent, RenderTargetComponent>();
+		const auto tilemapView = View<TransformComponent, TilemapComponent, RenderTargetComponent>();
 		const auto meshView = View<TransformComponent, MeshComponent, MaterialComponent, RenderTargetComponent>();
+		const auto occluderView = View<TransformComponent, MeshComponent, OccluderComponent, RenderTargetComponent>();
 
+		auto& renderer2DSingleton = SingletonView<Renderer2DSingleton>();
 		auto& renderer3DSingleton = SingletonView<Renderer3DSingleton>();
+		auto& viewSingleton = SingletonView<ViewSingleton>();
+
+		// Remapped once when added, the component keeps the page and region from then on
+		if (const Ref<TextureAtlas>& atlas = renderer2DSingleton.GetSpriteAtlas())
+		{
+			const auto allSpriteView = View<SpriteComponent>();
+			for (const entt::entity entity : InitView<SpriteComponent>())
+			{
+				if (allSpriteView.contains(entity))
+				{
+					auto& sprite = allSpriteView.get<SpriteComponent>(entity);
+					atlas->Remap(sprite.TextureInstance, sprite.UVRect);
+				}
+			}
+		}
+
+		viewSingleton.BeginFrame(ts);
 
-		// Loop through each framebuffer
+		// Renderers of destroyed framebuffers would otherwise hold on to their GPU buffers for good
+		renderer2DSingleton.PruneTargets([&](const entt::entity entity) { return framebufferView.contains(entity); });
+
+		// Gather active framebuffers and the main camera linked to each of them
+		std::vector<RenderTarget> targets;
 		for (const auto fbEntity : framebufferView)
 		{
 			const auto& framebufferComp = framebufferView.get<FramebufferComponent>(fbEntity);
@@ -54,68 +198,244 @@ namespace Snowstorm
 				continue;
 			}
 
-			// Start rendering
-			const Ref<Framebuffer> framebuffer = framebufferComp.Framebuffer;
-			PrepareFramebuffer(framebuffer);
+			RenderTarget& target = targets.emplace_back();
+			target.Entity = fbEntity;
+			target.Framebuffer = framebufferComp.Framebuffer;
 
-			// Find the main camera linked to this framebuffer
-			const Camera* mainCamera = nullptr;
-			glm::mat4 cameraTransform{};
-			FindMainCamera(fbEntity, cameraView, mainCamera, cameraTransform);
+			FindMainCamera(fbEntity, cameraView, target.MainCamera, target.CameraTransform);
 
-			if (!mainCamera)
+			if (target.MainCamera)
 			{
-				framebuffer->Unbind();
-				continue;
+				const FramebufferSpecification& specification = target.Framebuffer->GetSpecification();
+				target.ViewIndex = viewSingleton.AddView(*target.MainCamera, target.CameraTransform,
+				                                         {specification.Width, specification.Height});
+
+				target.SpriteRenderer = &renderer2DSingleton.GetRenderer(fbEntity);
+				target.SpriteQueue = &renderer2DSingleton.GetQueue(fbEntity);
+			}
+		}
+
+		// Every view of the frame goes up in one upload, passes then only bind their range
+		viewSingleton.Upload();
+
+		renderer2DSingleton.ResetStats();
+		renderer3DSingleton.ResetStats();
+		renderer3DSingleton.BeginFrame();
+
+		for (const auto& target : targets)
+		{
+			if (target.SpriteRenderer)
+			{
+				target.SpriteRenderer->BeginScene();
+			}
+		}
+
+		// Record sprites for all targets in parallel
+		JobSystem::ParallelFor(static_cast<uint32_t>(targets.size()), 1, [&](const uint32_t begin, const uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				if (targets[i].SpriteRenderer)
+				{
+					RecordSprites(targets[i], viewSingleton.GetView(targets[i].ViewIndex), spriteView, textView);
+				}
 			}
+		});
+
+		// Scratch for mesh culling, reused across targets
+		std::vector<entt::entity> meshes;
+		std::vector<glm::mat4> meshTransforms;
+		PackedBounds meshBounds;
+		std::vector<uint8_t> meshVisibility;
 
-			// Draw sprites
+		auto& renderGraphSingleton = SingletonView<RenderGraphSingleton>();
+		RenderGraph& graph = renderGraphSingleton.GetGraph();
+		graph.Reset();
+
+		// Every target is drawn by its own chain of passes, in the order the targets were gathered
+		for (const auto& target : targets)
+		{
+			const RenderGraphResource output = graph.ImportFramebuffer(
+				"Framebuffer " + std::to_string(static_cast<uint32_t>(target.Entity)), target.Framebuffer);
+
+			graph.AddPass("Sprites", [&](RenderGraphBuilder& builder)
+			{
+				builder.Write(output);
+			}, [&, output](const RenderGraphContext& context)
 			{
-				Renderer2D::ResetStats();
-				Renderer2D::BeginScene(*mainCamera, cameraTransform);
+				PrepareFramebuffer(context.GetFramebuffer(output));
+
+				if (!target.MainCamera)
+				{
+					return;
+				}
+
+				viewSingleton.Bind(target.ViewIndex);
 
-				for (const auto entity : spriteView)
+				// Draw tilemaps
+				TilemapRenderer& tilemapRenderer = renderer2DSingleton.GetTilemapRenderer();
+				tilemapRenderer.BeginScene(viewSingleton.GetView(target.ViewIndex));
+
+				for (const auto entity : tilemapView)
 				{
-					if (auto& [targetFramebuffer] = spriteView.get<RenderTargetComponent>(entity); targetFramebuffer ==
-						fbEntity) // Match framebuffer
+					if (auto& [targetFramebuffer] = tilemapView.get<RenderTargetComponent>(entity); targetFramebuffer ==
+						target.Entity)
 					{
-						if (auto [transform, sprite] = spriteView.get<TransformComponent, SpriteComponent>(entity);
-							sprite.TextureInstance)
+						auto [transform, tilemap] = tilemapView.get<TransformComponent, TilemapComponent>(entity);
+						if (tilemap.TilemapInstance)
 						{
-							Renderer2D::DrawQuad(transform, sprite.TextureInstance, sprite.TilingFactor,
-							                     sprite.TintColor);
+							tilemapRenderer.DrawTilemap(*tilemap.TilemapInstance, transform, tilemap.TintColor);
 						}
-						else
+					}
+				}
+
+				// Draw sprites
+				target.SpriteRenderer->Flush();
+			});
+
+			if (target.MainCamera)
+			{
+				graph.AddPass("Meshes", [&](RenderGraphBuilder& builder)
+				{
+					builder.Write(output);
+				}, [&, output](const RenderGraphContext& context)
+				{
+					context.GetFramebuffer(output)->Bind();
+
+					const ViewData& view = viewSingleton.GetView(target.ViewIndex);
+					viewSingleton.Bind(target.ViewIndex);
+					renderer3DSingleton.BeginScene(view);
+
+					meshes.clear();
+					for (const auto entity : meshView)
+					{
+						if (auto& [targetFramebuffer] = meshView.get<RenderTargetComponent>(entity);
+							targetFramebuffer == target.Entity)
 						{
-							Renderer2D::DrawQuad(transform, sprite.TintColor);
+							meshes.push_back(entity);
 						}
 					}
-				}
 
-				Renderer2D::EndScene();
+					// Only meshes whose world bounds touch the camera's frustum are drawn
+					const auto meshCount = static_cast<uint32_t>(meshes.size());
+					meshTransforms.resize(meshCount);
+					meshBounds.Resize(meshCount);
+
+					const glm::mat4& projection = view.Projection;
+					const glm::mat4& viewProjection = view.ViewProjection;
+
+					JobSystem::ParallelFor(meshCount, MeshesPerJob, [&](const uint32_t begin, const uint32_t end)
+					{
+						for (uint32_t i = begin; i < end; i++)
+						{
+							auto [transform, mesh] = meshView.get<TransformComponent, MeshComponent>(meshes[i]);
+
+							meshTransforms[i] = transform;
+							const AABB bounds = mesh.MeshInstance->GetBounds().Transform(meshTransforms[i]);
+							meshBounds.Set(i, bounds);
+
+							// Fraction of the viewport height the bounding sphere covers (w is 1 for orthographic cameras),
+							// halved since the viewport is two units high in NDC
+							const float w = (viewProjection * glm::vec4(bounds.GetCenter(), 1.0f)).w;
+							const float radius = length(bounds.GetExtents());
+							const float screenSize = w > radius
+								                         ? 0.5f * radius * projection[1][1] / w
+								                         : std::numeric_limits<float>::max();
+
+							mesh.LOD = mesh.MeshInstance->SelectLOD(screenSize, mesh.LOD, MaxLODScreenError,
+							                                        LODHysteresis);
+						}
+					});
+
+					const Frustum frustum = view.GetFrustum();
+					const uint32_t visibleCount = frustum.Cull(meshBounds, meshVisibility);
+					renderer3DSingleton.AddCulledMeshes(meshCount - visibleCount);
+
+					// Then the ones hidden behind the target's occluders
+					OcclusionCuller& occlusionCuller = renderer3DSingleton.GetOcclusionCuller();
+					occlusionCuller.BeginFrame(viewProjection);
+
+					for (const auto entity : occluderView)
+					{
+						if (auto& [targetFramebuffer] = occluderView.get<RenderTargetComponent>(entity);
+							targetFramebuffer == target.Entity)
+						{
+							auto [transform, mesh, occluder] = occluderView.get<TransformComponent, MeshComponent,
+							                                                    OccluderComponent>(entity);
+							const Ref<Mesh>& occluderMesh = occluder.OccluderMesh
+								                                ? occluder.OccluderMesh
+								                                : mesh.MeshInstance;
+							occlusionCuller.AddOccluder(occluderMesh, transform);
+						}
+					}
+
+					if (occlusionCuller.HasOccluders())
+					{
+						occlusionCuller.Rasterize();
+						renderer3DSingleton.AddOccludedMeshes(occlusionCuller.Cull(meshBounds, meshVisibility));
+					}
+
+					// Turn the visible meshes into draw packets on the workers, only submitting them touches the renderer
+					RenderQueue3D& queue = renderer3DSingleton.GetQueue();
+					const glm::mat4& viewMatrix = view.View;
+					const glm::vec4 depthRow{viewMatrix[0][2], viewMatrix[1][2], viewMatrix[2][2], viewMatrix[3][2]};
+
+					queue.Record(meshCount, MeshesPerJob, [&](const uint32_t begin, const uint32_t end,
+					                                          RenderQueue3D::Bucket& bucket)
+					{
+						for (uint32_t i = begin; i < end; i++)
+						{
+							if (!meshVisibility[i])
+							{
+								continue;
+							}
+
+							auto [mesh, material] = meshView.get<MeshComponent, MaterialComponent>(meshes[i]);
+
+							// Every level is its own mesh, so it gets its own batches
+							const Ref<Mesh>& lodMesh = mesh.LOD == 0
+								                           ? mesh.MeshInstance
+								                           : mesh.MeshInstance->GetLOD(mesh.LOD).LODMesh;
+
+							const float depth = -dot(depthRow, meshTransforms[i][3]);
+							bucket.Add(meshTransforms[i], lodMesh, material.MaterialInstance, depth);
+						}
+					});
+
+					queue.Sort();
+					queue.Submit(renderer3DSingleton);
+
+					renderer3DSingleton.EndScene();
+				});
 			}
 
-			// Draw meshes
+			graph.AddPass("Present", [&](RenderGraphBuilder& builder)
 			{
-				renderer3DSingleton.BeginScene(*mainCamera, cameraTransform);
+				builder.Read(output);
+				builder.SetSideEffect();
+			}, [&, output](const RenderGraphContext& context)
+			{
+				const Ref<Framebuffer>& framebuffer = context.GetFramebuffer(output);
+				framebuffer->Unbind();
 
-				for (const auto entity : meshView)
+				if (target.MainCamera)
 				{
-					if (auto& [targetFramebuffer] = meshView.get<RenderTargetComponent>(entity); targetFramebuffer ==
-						fbEntity)
-					{
-						auto [transform, mesh, material] = meshView.get<
-							TransformComponent, MeshComponent, MaterialComponent>(entity);
-						renderer3DSingleton.DrawMesh(transform, mesh.MeshInstance, material.MaterialInstance);
-					}
+					framebuffer->Blit();
 				}
+			});
+		}
 
-				renderer3DSingleton.EndScene();
-			}
+		if (graph.Compile())
+		{
+			graph.Execute();
+		}
 
-			// End rendering
-			framebuffer->Unbind();
-			framebuffer->Blit();
+		// Fences the instances of every target's scene at once
+		renderer3DSingleton.EndFrame();
+
+		if (renderGraphSingleton.ConsumeDumpRequest())
+		{
+			SS_CORE_INFO("{0}", graph.Dump());
 		}
 	}
 }
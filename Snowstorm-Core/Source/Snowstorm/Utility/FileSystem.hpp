@@ -0,0 +1,13 @@
+#pragma once
+
+#include <filesystem>
+
+namespace Snowstorm
+{
+	// Whether both paths name the same existing file, however each of them is spelled
+	inline bool IsSameFile(const std::filesystem::path& a, const std::filesystem::path& b)
+	{
+		std::error_code error;
+		return std::filesystem::equivalent(a, b, error);
+	}
+}
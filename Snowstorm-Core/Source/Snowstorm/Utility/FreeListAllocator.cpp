@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "FreeListAllocator.hpp"
+
+namespace Snowstorm
+{
+	FreeListAllocator::FreeListAllocator(const uint32_t capacity)
+	{
+		Grow(capacity);
+	}
+
+	std::optional<uint32_t> FreeListAllocator::Allocate(const uint32_t size)
+	{
+		if (size == 0)
+		{
+			return 0;
+		}
+
+		for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); ++it)
+		{
+			const auto [offset, rangeSize] = *it;
+			if (rangeSize < size)
+			{
+				continue;
+			}
+
+			m_FreeRanges.erase(it);
+			if (rangeSize > size)
+			{
+				m_FreeRanges.emplace(offset + size, rangeSize - size);
+			}
+
+			m_Used += size;
+			return offset;
+		}
+
+		return std::nullopt;
+	}
+
+	void FreeListAllocator::Free(uint32_t offset, uint32_t size)
+	{
+		if (size == 0)
+		{
+			return;
+		}
+
+		SS_CORE_ASSERT(offset + size <= m_Capacity, "Freed range is outside of the allocator!");
+		m_Used -= size;
+
+		// Merge with the free ranges right after and right before
+		auto next = m_FreeRanges.lower_bound(offset);
+		if (next != m_FreeRanges.end() && offset + size == next->first)
+		{
+			size += next->second;
+			next = m_FreeRanges.erase(next);
+		}
+
+		if (next != m_FreeRanges.begin())
+		{
+			if (const auto previous = std::prev(next); previous->first + previous->second == offset)
+			{
+				previous->second += size;
+				return;
+			}
+		}
+
+		m_FreeRanges.emplace_hint(next, offset, size);
+	}
+
+	void FreeListAllocator::Grow(const uint32_t capacity)
+	{
+		if (capacity <= m_Capacity)
+		{
+			return;
+		}
+
+		const uint32_t previousCapacity = m_Capacity;
+		m_Capacity = capacity;
+
+		// The new space is free, Free merges it with a free range at the old end
+		m_Used += capacity - previousCapacity;
+		Free(previousCapacity, capacity - previousCapacity);
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace Snowstorm
+{
+	// Hands out ranges of an abstract [0, capacity) address space, for sub-allocating buffers
+	// Free ranges are kept sorted by offset and merged with their neighbours when released. Allocation is first fit.
+	class FreeListAllocator
+	{
+	public:
+		explicit FreeListAllocator(uint32_t capacity = 0);
+
+		// Offset of a range of size elements, nullopt if no free range is large enough
+		std::optional<uint32_t> Allocate(uint32_t size);
+		void Free(uint32_t offset, uint32_t size);
+
+		// Appends free space at the end, existing allocations keep their offsets
+		void Grow(uint32_t capacity);
+
+		[[nodiscard]] uint32_t GetCapacity() const { return m_Capacity; }
+		[[nodiscard]] uint32_t GetUsed() const { return m_Used; }
+
+	private:
+		std::map<uint32_t, uint32_t> m_FreeRanges; // Offset to size
+		uint32_t m_Capacity = 0;
+		uint32_t m_Used = 0;
+	};
+}
@@ -0,0 +1,118 @@
+#include "pch.h"
+#include "RadixSort.hpp"
+
+#include "Snowstorm/Core/JobSystem.hpp"
+
+namespace Snowstorm
+{
+	namespace
+	{
+		constexpr uint32_t RadixBits = 8;
+		constexpr uint32_t RadixSize = 1 << RadixBits;
+		constexpr uint32_t PassCount = 64 / RadixBits;
+
+		// Entries handled by one job, below this the sort runs on the calling thread
+		constexpr uint32_t EntriesPerChunk = 16384;
+
+		using Histogram = std::array<uint32_t, RadixSize>;
+
+		uint32_t GetDigit(const uint64_t key, const uint32_t pass)
+		{
+			return static_cast<uint32_t>(key >> (pass * RadixBits)) & (RadixSize - 1);
+		}
+	}
+
+	void RadixSort(std::vector<RadixSortEntry>& entries, std::vector<RadixSortEntry>& scratch)
+	{
+		SS_PROFILE_FUNCTION();
+
+		const auto count = static_cast<uint32_t>(entries.size());
+		if (count < 2)
+		{
+			return;
+		}
+
+		scratch.resize(count);
+
+		const uint32_t chunkCount = (count + EntriesPerChunk - 1) / EntriesPerChunk;
+		const auto chunkBegin = [](const uint32_t chunk) { return chunk * EntriesPerChunk; };
+		const auto chunkEnd = [count](const uint32_t chunk) { return std::min((chunk + 1) * EntriesPerChunk, count); };
+
+		// Passes where every key shares the same digit don't change the order
+		std::array<bool, PassCount> skipPass{};
+		{
+			uint64_t differingBits = 0;
+			const uint64_t firstKey = entries[0].Key;
+			for (const auto& entry : entries)
+			{
+				differingBits |= entry.Key ^ firstKey;
+			}
+
+			for (uint32_t pass = 0; pass < PassCount; pass++)
+			{
+				skipPass[pass] = GetDigit(differingBits, pass) == 0;
+			}
+		}
+
+		std::vector<Histogram> chunkOffsets(chunkCount);
+
+		RadixSortEntry* source = entries.data();
+		RadixSortEntry* destination = scratch.data();
+
+		for (uint32_t pass = 0; pass < PassCount; pass++)
+		{
+			if (skipPass[pass])
+			{
+				continue;
+			}
+
+			// Count digits per chunk
+			JobSystem::ParallelFor(chunkCount, 1, [&](const uint32_t first, const uint32_t last)
+			{
+				for (uint32_t chunk = first; chunk < last; chunk++)
+				{
+					Histogram& histogram = chunkOffsets[chunk];
+					histogram.fill(0);
+
+					for (uint32_t i = chunkBegin(chunk); i < chunkEnd(chunk); i++)
+					{
+						histogram[GetDigit(source[i].Key, pass)]++;
+					}
+				}
+			});
+
+			// Turn counts into output offsets, digit-major and chunk-minor so the sort stays stable
+			uint32_t offset = 0;
+			for (uint32_t digit = 0; digit < RadixSize; digit++)
+			{
+				for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+				{
+					const uint32_t digitCount = chunkOffsets[chunk][digit];
+					chunkOffsets[chunk][digit] = offset;
+					offset += digitCount;
+				}
+			}
+
+			// Scatter every chunk into its own output ranges
+			JobSystem::ParallelFor(chunkCount, 1, [&](const uint32_t first, const uint32_t last)
+			{
+				for (uint32_t chunk = first; chunk < last; chunk++)
+				{
+					Histogram& offsets = chunkOffsets[chunk];
+
+					for (uint32_t i = chunkBegin(chunk); i < chunkEnd(chunk); i++)
+					{
+						destination[offsets[GetDigit(source[i].Key, pass)]++] = source[i];
+					}
+				}
+			});
+
+			std::swap(source, destination);
+		}
+
+		if (source != entries.data())
+		{
+			entries.swap(scratch);
+		}
+	}
+}
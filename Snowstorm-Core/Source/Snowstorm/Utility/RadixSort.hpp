@@ -0,0 +1,26 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace Snowstorm
+{
+	struct RadixSortEntry
+	{
+		uint64_t Key;
+		uint32_t Value; // Usually an index into the data being sorted
+	};
+
+	// Maps a float onto an unsigned integer with the same ordering, for packing depths into keys
+	inline uint32_t ToSortableBits(const float value)
+	{
+		const auto bits = std::bit_cast<uint32_t>(value);
+		return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+	}
+
+	// Stable LSD radix sort on Key, split into chunks on the job system
+	// Byte passes in which every key has the same digit are skipped, so keys that only use a few bits stay cheap.
+	// scratch is resized to match entries and only holds temporary data afterwards.
+	void RadixSort(std::vector<RadixSortEntry>& entries, std::vector<RadixSortEntry>& scratch);
+}
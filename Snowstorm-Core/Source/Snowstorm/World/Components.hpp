@@ -6,9 +6,11 @@
 #include "SceneCamera.h"
 #include "ScriptableEntity.h"
 
+#include "Snowstorm/Render/Font.hpp"
 #include "Snowstorm/Render/Framebuffer.hpp"
 #include "Snowstorm/Render/Material.hpp"
 #include "Snowstorm/Render/Mesh.hpp"
+#include "Snowstorm/Render/Tilemap.hpp"
 
 namespace Snowstorm
 {
@@ -67,6 +69,13 @@ namespace Snowstorm
 	struct MeshComponent
 	{
 		Ref<Mesh> MeshInstance;
+		uint32_t LOD = 0; // Level drawn last frame, see Mesh::SelectLOD
+	};
+
+	// Hides the meshes of its render target behind it, see OcclusionCuller
+	struct OccluderComponent
+	{
+		Ref<Mesh> OccluderMesh; // Rasterized instead of the entity's mesh when set, has to fit inside it
 	};
 
 	struct SpriteComponent
@@ -74,6 +83,8 @@ namespace Snowstorm
 		Ref<Texture2D> TextureInstance;
 		float TilingFactor = 1.0f;
 		glm::vec4 TintColor = glm::vec4{1.0f};
+		glm::vec4 UVRect = {0.0f, 0.0f, 1.0f, 1.0f}; // Min (xy) and max (zw) texture coordinates, see TextureAtlas::Remap
+		uint8_t Layer = 0; // Higher layers are drawn on top, regardless of depth
 
 		SpriteComponent(Ref<Texture2D> textureInstance, const float tilingFactor = 1.0f,
 		                const glm::vec4& color = glm::vec4{1.0f})
@@ -87,6 +98,24 @@ namespace Snowstorm
 		}
 	};
 
+	// Batched with the sprites of its render target, the transform places the start of the first baseline
+	struct TextComponent
+	{
+		std::string Text;
+		Ref<Font> FontAsset;
+		glm::vec4 Color = glm::vec4{1.0f};
+		uint8_t Layer = 0;
+
+		TextLayout Layout; // Reshaped by the RenderSystem when Text or FontAsset change
+	};
+
+	// Drawn before the sprites of its render target, so place it behind them
+	struct TilemapComponent
+	{
+		Ref<Tilemap> TilemapInstance;
+		glm::vec4 TintColor = glm::vec4{1.0f};
+	};
+
 	struct CameraComponent
 	{
 		SceneCamera Camera;
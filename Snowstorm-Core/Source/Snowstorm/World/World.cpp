@@ -8,13 +8,16 @@
 
 #include "Snowstorm/Events/Event.h"
 #include "Snowstorm/Render/MeshLibrarySingleton.hpp"
+#include "Snowstorm/Render/RenderGraphSingleton.hpp"
+#include "Snowstorm/Render/Renderer2DSingleton.hpp"
 #include "Snowstorm/Render/Renderer3DSingleton.hpp"
 #include "Snowstorm/Render/Shader.hpp"
+#include "Snowstorm/Render/ViewSingleton.hpp"
 
+#include "Snowstorm/System/AssetReloadSystem.hpp"
 #include "Snowstorm/System/CameraControllerSystem.hpp"
 #include "Snowstorm/System/RenderSystem.hpp"
 #include "Snowstorm/System/ScriptSystem.hpp"
-#include "Snowstorm/System/ShaderReloadSystem.hpp"
 #include "Snowstorm/System/ViewportResizeSystem.hpp"
 
 namespace Snowstorm
@@ -29,13 +32,16 @@ namespace Snowstorm
 		m_SystemManager->RegisterSystem<ScriptSystem>(this);
 		m_SystemManager->RegisterSystem<ViewportResizeSystem>(this);
 		m_SystemManager->RegisterSystem<CameraControllerSystem>(this);
-		m_SystemManager->RegisterSystem<ShaderReloadSystem>(this);
+		m_SystemManager->RegisterSystem<AssetReloadSystem>(this);
 		m_SystemManager->RegisterSystem<RenderSystem>(this);
 
 		m_SingletonManager->RegisterSingleton<EventsHandlerSingleton>();
 		m_SingletonManager->RegisterSingleton<ShaderLibrarySingleton>();
 		m_SingletonManager->RegisterSingleton<MeshLibrarySingleton>();
+		m_SingletonManager->RegisterSingleton<Renderer2DSingleton>();
 		m_SingletonManager->RegisterSingleton<Renderer3DSingleton>();
+		m_SingletonManager->RegisterSingleton<RenderGraphSingleton>();
+		m_SingletonManager->RegisterSingleton<ViewSingleton>();
 	}
 
 	Entity World::CreateEntity(const std::string& name)
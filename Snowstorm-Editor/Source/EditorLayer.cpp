@@ -8,9 +8,12 @@
 #include "Examples/MandelbrotSet/MandelbrotControllerSystem.hpp"
 
 #include "Snowstorm/ECS/SystemManager.hpp"
+#include "Snowstorm/Events/ApplicationEvent.h"
 #include "Snowstorm/Events/KeyEvent.h"
 #include "Snowstorm/Events/MouseEvent.h"
 #include "Snowstorm/Render/MeshLibrarySingleton.hpp"
+#include "Snowstorm/Render/RenderGraphSingleton.hpp"
+#include "Snowstorm/Render/Renderer3DSingleton.hpp"
 
 namespace Snowstorm
 {
@@ -128,6 +131,17 @@ namespace Snowstorm
 		SS_PROFILE_FUNCTION();
 
 		m_ActiveWorld->OnUpdate(ts);
+
+		// Errors stay listed until their shader reloads successfully
+		auto& eventsHandler = m_ActiveWorld->GetSingleton<EventsHandlerSingleton>();
+		for (const auto& event : eventsHandler.Process<ShaderCompileFailedEvent>())
+		{
+			m_ShaderErrors[event->Filepath] = event->Log;
+		}
+		for (const auto& event : eventsHandler.Process<ShaderReloadedEvent>())
+		{
+			m_ShaderErrors.erase(event->Filepath);
+		}
 	}
 
 	void EditorLayer::OnImGuiRender()
@@ -212,12 +226,78 @@ namespace Snowstorm
 
 		ImGui::Begin("Settings");
 
-		const auto stats = Renderer2D::GetStats();
+		for (const auto& [filepath, log] : m_ShaderErrors)
+		{
+			ImGui::TextColored({1.0f, 0.3f, 0.3f, 1.0f}, "Shader '%s' failed to compile:", filepath.c_str());
+			ImGui::TextWrapped("%s", log.c_str());
+			ImGui::Separator();
+		}
+
+		auto& renderer2D = m_ActiveWorld->GetSingleton<Renderer2DSingleton>();
+		const auto stats = renderer2D.GetStats();
 		ImGui::Text("Renderer2D Stats:");
 		ImGui::Text("Draw Calls: %d", stats.DrawCalls);
 		ImGui::Text("Quads: %d", stats.QuadCount);
 		ImGui::Text("Vertices: %d", stats.GetTotalVertexCount());
 		ImGui::Text("Indices: %d", stats.GetTotalIndexCount());
+		ImGui::Text("Quads per Draw Call: %.1f", stats.GetQuadsPerDrawCall());
+		ImGui::Text("Uploaded: %.1f KB", static_cast<double>(stats.UploadBytes) / 1024.0);
+		ImGui::Text("Culled Quads: %d", stats.CulledQuadCount);
+
+		const auto tilemapStats = renderer2D.GetTilemapStats();
+		ImGui::Text("Tilemap Chunks: %d visible, %d culled", tilemapStats.VisibleChunks, tilemapStats.CulledChunks);
+		ImGui::Text("Tilemap Rebuilds: %d (%.1f KB)", tilemapStats.RebuiltChunks,
+		            static_cast<double>(tilemapStats.UploadBytes) / 1024.0);
+
+		const auto stats3D = m_ActiveWorld->GetSingleton<Renderer3DSingleton>().GetStats();
+		ImGui::Text("Renderer3D Stats:");
+		ImGui::Text("Draw Calls: %d (%d indirect draws)", stats3D.DrawCalls, stats3D.IndirectDraws);
+		ImGui::Text("Meshes: %d", stats3D.MeshCount);
+		ImGui::Text("Triangles: %d", stats3D.TriangleCount);
+		ImGui::Text("Culled Meshes: %d", stats3D.CulledMeshCount);
+		ImGui::Text("Occluded Meshes: %d", stats3D.OccludedMeshCount);
+		ImGui::Text("Resident Meshes: %d (%.1f MB)", stats3D.ResidentMeshes,
+		            static_cast<double>(stats3D.ResidentBytes) / (1024.0 * 1024.0));
+		ImGui::Text("Mesh Uploads: %d (%.1f KB), %d evicted", stats3D.MeshUploads,
+		            static_cast<double>(stats3D.UploadBytes) / 1024.0, stats3D.EvictedMeshes);
+		ImGui::Text("State Changes: %d issued, %d skipped", stats3D.StateChanges, stats3D.SkippedStateChanges);
+		ImGui::Text("Material Uploads: %d", stats3D.MaterialUploads);
+
+		auto& renderer3D = m_ActiveWorld->GetSingleton<Renderer3DSingleton>();
+		if (renderer3D.IsOverdrawCounting())
+		{
+			ImGui::Text("Overdraw: %.2f samples per pixel", stats3D.GetOverdraw());
+		}
+
+		if (bool instancedQuads = renderer2D.GetQuadMode() == Renderer2D::QuadMode::Instanced;
+			ImGui::Checkbox("Instanced Quads", &instancedQuads))
+		{
+			renderer2D.SetQuadMode(instancedQuads ? Renderer2D::QuadMode::Instanced : Renderer2D::QuadMode::Vertices);
+		}
+
+		if (Renderer2D::SupportsBindlessTextures())
+		{
+			if (bool bindlessTextures = renderer2D.UsesBindlessTextures();
+				ImGui::Checkbox("Bindless Textures", &bindlessTextures))
+			{
+				renderer2D.SetBindlessTextures(bindlessTextures);
+			}
+		}
+
+		if (bool depthPrepass = renderer3D.IsDepthPrepassEnabled(); ImGui::Checkbox("Depth Prepass", &depthPrepass))
+		{
+			renderer3D.SetDepthPrepass(depthPrepass);
+		}
+
+		if (bool countOverdraw = renderer3D.IsOverdrawCounting(); ImGui::Checkbox("Count Overdraw", &countOverdraw))
+		{
+			renderer3D.SetOverdrawCounting(countOverdraw);
+		}
+
+		if (ImGui::Button("Dump Render Graph"))
+		{
+			m_ActiveWorld->GetSingleton<RenderGraphSingleton>().RequestDump();
+		}
 
 		if (m_SquareEntity)
 		{
@@ -280,6 +360,12 @@ namespace Snowstorm
 				{
 					eventsHandler.PushEvent<MouseScrolledEvent>(dynamic_cast<MouseScrolledEvent&>(e));
 				}
+			},
+			{
+				EventType::FileChanged, [&eventsHandler](Event& e)
+				{
+					eventsHandler.PushEvent<FileChangedEvent>(dynamic_cast<FileChangedEvent&>(e));
+				}
 			}
 		};
 
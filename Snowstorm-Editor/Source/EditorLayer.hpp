@@ -27,6 +27,8 @@ namespace Snowstorm
 
 		bool m_PrimaryCamera = true;
 
+		std::unordered_map<std::string, std::string> m_ShaderErrors; // Compile log per shader path
+
 		// Panels (shouldn't be in world)
 		SceneHierarchyPanel m_SceneHierarchyPanel;
 	};